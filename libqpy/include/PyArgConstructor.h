@@ -44,13 +44,27 @@ namespace qpy {
 /// format; in the case of (2) the return value must first be stored into
 /// a memory location passed to the method invocation function, and then
 /// be converted into Python format.
+/// The memory location is created by Construct() into per-call storage of
+/// StorageSize() bytes provided by the run-time; constructors which do not
+/// override Construct() use the location referenced by Argument() instead
+/// and are therefore not reentrant.
 class PyArgConstructor {
 public:
-    /// @brief Create PyObject from value returned from QObject method.
-    virtual PyObject* Create() const = 0;
+    /// @brief Create PyObject from value returned from QObject method and
+    /// stored into the location referenced by Argument().
+    virtual PyObject* Create() const { return Create( Argument().data() ); }
     /// @brief Create PyObject from parameter passed to Python callback
-    /// from Qt when signal triggered
+    /// from Qt when signal triggered or from value returned from QObject
+    /// method and stored at the address returned by Construct() 
     virtual PyObject* Create( void* ) const = 0;
+    /// Size in bytes of the storage required by Construct().
+    virtual size_t StorageSize() const { return 0; }
+    /// @brief Default-construct placeholder for returned value into memory
+    /// area of StorageSize() bytes.
+    /// @return address of placeholder; NULL if type is void 
+    virtual void* Construct( void* /*storage*/ ) const { return Argument().data(); }
+    /// Destroy placeholder created by Construct().
+    virtual void Destroy( void* ) const {}
     /// Virtual destructor.
     virtual ~PyArgConstructor() {}
     /// Return copy of object.
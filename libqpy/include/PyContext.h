@@ -38,6 +38,11 @@
 #include <QList>
 #include <QString>
 #include <QSet>
+#include <QThread>
+#include <QVarLengthArray>
+#include <QVector>
+#include <QHash>
+#include <QPair>
 #include <string>
 #include <vector>
 #include <QDebug>
@@ -45,7 +50,11 @@
 #include "detail/PyArgWrappers.h"
 #include "detail/PyCallbackDispatcher.h"
 #include "detail/PyQVariantDefault.h"
+#include "detail/PyDefaultConverters.h"
+#include "detail/PyVariantConverter.h"
+#include "detail/PyVariantView.h"
 #include "PyMemberNameMapper.h"
+#include "PyConverter.h"
 
 
 #define PY_CHECK( f ) {if( f != 0 ) throw std::runtime_error( "Python error" );}
@@ -58,6 +67,13 @@ inline void RaisePyError( const char* errMsg = 0,
     PyErr_SetString( errType, errMsg );
 }
 
+/// @brief Create constructor instance used by PyContext::RegisterType;
+/// @c NULL for NoQArgConstructor and NoPyArgConstructor, i.e. conversion
+/// not available.
+template < typename T > T* NewArgConstructor() { return new T; }
+template <> inline NoQArgConstructor* NewArgConstructor< NoQArgConstructor >() { return 0; }
+template <> inline NoPyArgConstructor* NewArgConstructor< NoPyArgConstructor >() { return 0; }
+
 ///@todo 
 /// - search for Q_PROPERTY doc, if available use that for __doc__ attr
 /// - add Q_PROPERTY support
@@ -81,27 +97,121 @@ class PyContext {
     /// to be used at invocation time and the QMetaMethod to use for the actual
     /// invocation.
     struct Method {
-        //for overloading purposes:
-        //QMap< int, tuple< QMetaMethod, QArgWrappers, PyArgWrapper> >
-        //select the one matching the number of arguments
         QMetaMethod metaMethod_;
         QArgWrappers argumentWrappers_;
         PyArgWrapper returnWrapper_;
         const QMetaObject* metaObject_;
+        /// Absolute method index passed to @c QMetaObject::metacall or
+        /// constructor index in case of constructors
+        int index_;
+        /// Number of parameters: size of argument array passed to
+        /// @c QMetaObject::metacall is @c arity_ + 1 (return value)
+        int arity_;
+        /// Parameter type names, used when the method is invoked through
+        /// @c QMetaMethod::invoke
+        ArgumentTypes argumentTypes_;
+        /// Size of per-call storage for arguments and return value
+        int storageSize_;
         Method( const QMetaMethod& mm,
                 const QArgWrappers& pw,
                 const PyArgWrapper& rw,
-                const QMetaObject* mo ) :
+                const QMetaObject* mo,
+                int index = -1 ) :
             metaMethod_( mm ), argumentWrappers_( pw ),
-            returnWrapper_( rw ), metaObject_( mo ) {}
+            returnWrapper_( rw ), metaObject_( mo ),
+            index_( index < 0 ? mm.methodIndex() : index ), arity_( pw.size() ),
+            argumentTypes_( mm.parameterTypes() ),
+            storageSize_( CallFrame::AlignedSize( rw.StorageSize() ) ) {
+            for( QArgWrappers::const_iterator i = pw.begin(); i != pw.end(); ++i ) {
+                storageSize_ += CallFrame::AlignedSize( i->StorageSize() );
+            }
+        }
+    };
+    /// @brief Property accessor: property index and converters are resolved
+    /// at type creation time.
+    ///
+    /// Properties of types with registered converters are read and written
+    /// through @c QMetaObject::metacall passing a pointer to a value of the
+    /// property type; other properties are accessed through QVariant and the
+    /// QVariant <--> Python converters.
+    struct Property {
+        QMetaProperty metaProperty_;
+        /// Absolute property index passed to @c QMetaObject::metacall
+        int index_;
+        /// Qt -> Python converter, valid if typedRead_ is @c true
+        PyArgWrapper reader_;
+        /// Python -> Qt converter, valid if typedWrite_ is @c true
+        QArgWrapper writer_;
+        bool typedRead_;
+        bool typedWrite_;
+        Property( const QMetaProperty& mp, int index,
+                  const PyArgWrapper& reader, bool typedRead,
+                  const QArgWrapper& writer, bool typedWrite ) :
+            metaProperty_( mp ), index_( index ), 
+            reader_( reader ), writer_( writer ),
+            typedRead_( typedRead ), typedWrite_( typedWrite ) {}
+    };
+    typedef QList< Property > Properties;
+    /// @brief Methods mapped to the same Python name.
+    ///
+    /// Overloaded methods are grouped by number of parameters at type creation
+    /// time; moc-generated clones of methods with default arguments are
+    /// stored as methods with fewer parameters, default values being then
+    /// set by the moc-generated code at invocation time.
+    /// In the common case of a single method with the requested number of
+    /// arguments selection requires only an array access; Python types are
+    /// checked only when more methods with the same number of parameters exist.
+    class Overloads {
+    public:
+        /// Add method to dispatch table.
+        void Add( const Method* m ) {
+            if( m->arity_ >= byArity_.size() ) byArity_.resize( m->arity_ + 1 );
+            byArity_[ m->arity_ ].push_back( m );
+            all_.push_back( m );
+        }
+        /// Select method matching arguments; returns NULL and sets Python
+        /// exception if no method matches.
+        const Method* Resolve( PyObject* args ) const;
+        /// First method added.
+        const Method* First() const { return all_.front(); }
+        /// Return first signal or NULL if no signal available.
+        const Method* Signal() const;
+        /// Return first method whose signature is compatible with signal or
+        /// NULL if no compatible method available.
+        const Method* Slot( const Method& signal ) const;
+    private:
+        /// Dispatch table: one list of methods per arity.
+        QVector< QVector< const Method* > > byArity_;
+        /// Methods in declaration order.
+        QVector< const Method* > all_;
     };
+    /// Maximum number of arguments accepted by @c QMetaMethod::invoke
     static const int MAX_GENERIC_ARGS = 10;
+    /// Arguments passed to @c QMetaMethod::invoke
+    typedef QVarLengthArray< QGenericArgument, MAX_GENERIC_ARGS > GenericArguments;
 public:
     typedef QList< Method > Methods;
 public:  //must be public because type access might be needed
          //from PyArguments; declaring some PyArguments as friend
          //won't work when new argument constructors provided by
          //client code need to be registered
+    /// @brief Member of a lazy type not yet added to the Python type:
+    /// either a set of overloaded methods or a property.
+    struct LazyMember {
+        QVector< int > methods;
+        int property;
+        const char* doc;
+        LazyMember() : property( -1 ), doc( 0 ) {}
+    };
+    /// Lazy members indexed by Python name
+    typedef QHash< QByteArray, LazyMember > LazyMembers;
+    struct Type;
+    /// @brief Python type object of QObject wrappers: gives direct access
+    /// to the type information from the Python type.
+    struct PyQType {
+        PyTypeObject pyType;
+        Type* type;
+    };
     /// @brief Stores type information needed for invoking
     /// methods from Python.
     ///
@@ -109,15 +219,25 @@ public:  //must be public because type access might be needed
     /// type wrapping Qt classes.  
     struct Type {
         const QMetaObject* metaObject; 
-        //for overloading purposes:
-        //QMap< int, QArgWrappers >
-        //currently overloading is done through a run-time search
-        QList< QArgWrappers > ctorParams;
+        Methods constructors;
+        Overloads ctorOverloads;
         Methods methods;
-        PyTypeObject pyType;
+        /// Overloaded methods, one element per Python method name;
+        /// referenced by PyGetSetDef closures 
+        QList< Overloads > overloads;
+        /// Property accessors, referenced by PyGetSetDef closures
+        Properties properties;
+        /// Property accessors indexed by Python name
+        QHash< QByteArray, const Property* > propertyIndex;
+        PyQType pyQType;
         //required to keep char* to be passed around
         std::vector< std::string > pyMethodNames;
         std::vector< PyGetSetDef > pyMembers;
+        /// Members added to the Python type on first access, lazy types only
+        LazyMembers lazyMembers;
+        /// Indices of methods returning a lazy view, see
+        /// PyMemberNameMapper::returnView
+        QSet< int > viewMethods;
         // need string to pass references to
         // contained c_str
         std::string fullClassName;
@@ -126,41 +246,133 @@ public:  //must be public because type access might be needed
         PyObject* pyModule;
         PyContext* pyContext;
     };
-    typedef QList< Type > Types;
+    /// Types are heap allocated and never moved: Type pointers stored in
+    /// PyCapsules and closures remain valid for the lifetime of the context.
+    typedef QList< Type* > Types;
+    /// Type lookup key: types are registered per module
+    typedef QPair< const QMetaObject*, PyObject* > TypeKey;
+    typedef QHash< TypeKey, Type* > TypeIndex;
     /// @bried PyObject type   
     struct PyQObject {
         PyObject_HEAD
-        char qobjectTag;
         QObject* obj;
         Type* type;
-        PyObject* invoke; //method invocation function
         bool foreignOwned;
-        PyObject* pyModule;
+    };
+    /// @brief Python bound method: binds a set of overloaded methods to a
+    /// PyQObject instance.
+    ///
+    /// Returned when a method is accessed as an attribute of a PyQObject;
+    /// holds a reference to the wrapper, can therefore be stored and invoked
+    /// at a later time.
+    struct PyQMethod {
+        PyObject_HEAD
+        PyQObject* self;
+        const Overloads* overloads;
+    };
+    /// @brief Maps QObject instances to their Python wrappers, guaranteeing that
+    /// the same QObject is always wrapped by the same PyQObject.
+    ///
+    /// Wrappers are referenced weakly: entries are removed when a wrapper is
+    /// deallocated or, through QObject::destroyed, when the wrapped QObject is
+    /// deleted; in the latter case the wrapper's QObject pointer is set to NULL.
+    /// As with PyCallbackDispatcher no moc generated code is required: the
+    /// destroyed signal is routed to the first method index past the ones
+    /// declared in QObject.
+    /// The cache is accessed with the GIL held: QObjects deleted in a thread
+    /// other than the interpreter's acquire it through PyGILState_Ensure,
+    /// which requires PyEval_InitThreads to have been called, and must not
+    /// be waited for by a thread holding the GIL. QObjects deleted while or
+    /// after the interpreter is finalized are handled without the GIL.
+    class WrapperCache : public QObject {
+    public:
+        /// Return wrapper of QObject or NULL if not in cache
+        PyQObject* Find( QObject* obj ) const {
+            return wrappers_.value( obj, 0 );
+        }
+        /// Add wrapper to cache and track destruction of wrapped QObject
+        void Insert( PyQObject* pyqobj );
+        /// Remove wrapper from cache
+        void Remove( PyQObject* pyqobj );
+        /// Overridden method: invalidates the wrapper of destroyed QObjects;
+        /// invoked in the thread deleting the QObject
+        int qt_metacall( QMetaObject::Call c, int id, void** arguments );
+    private:
+        QHash< QObject*, PyQObject* > wrappers_;
+    };
+    /// @brief Pre-resolved list of properties of a type, returned by
+    /// @c qpy.property_set and accepted by @c qpy.get_properties and
+    /// @c qpy.set_properties in place of property names.
+    struct PyQPropertySet {
+        PyObject_HEAD
+        Type* type;
+        /// Property names, used as keys of returned dictionaries
+        PyObject* names;
+        QVector< const Property* >* properties;
     };
 public:
     /// Constructor: Create @c qpy module with QPy interface.
-    PyContext() {
+    PyContext() : lazyTypes_( false ) {
+        ++numContexts_;
+        dispatcher_.SetPyContext( this );
         InitArgFactory();
         InitQVariantPyObjectMaps();
     }
     /// Destructor: free all QVariant <--> Python converters that are not
-    /// foreign owned
+    /// foreign owned; the last context destroyed before the interpreter is
+    /// finalized also releases the free list of wrappers, see ClearFreeList,
+    /// and the string cache.
     ~PyContext() {
+        if( --numContexts_ == 0 && Py_IsInitialized() ) {
+            ClearFreeList();
+            SetStringCacheSize( 0 );
+        }
         for( QVariantToPyObjectMapType::iterator i = qvariantToPyObject_.begin();
              i != qvariantToPyObject_.end(); ++i ) {
-            if( !i.value()->ForeignOwned() ) delete i.value();
+            if( *i && !( *i )->ForeignOwned() ) delete *i;
         }
         for( PyObjectToQVariantMapType::iterator i = pyObjectToQVariant_.begin();
              i != pyObjectToQVariant_.end(); ++i ) {
-            if( !i.value()->ForeignOwned() ) delete i.value();
+            if( *i && !( *i )->ForeignOwned() ) delete *i;
         }      
+        qDeleteAll( types_ );
+        qDeleteAll( qArgConstructors_ );
+        qDeleteAll( pyArgConstructors_ );
     }
     /// Return version info
     static const char* Version();
-    /// Add QPy globals to Python interpreter; currently only @c __version__ is added.
+    /// Add QPy globals to Python interpreter: @c __version__ and @c QObject,
+    /// the base type of all QObject wrappers.
     void AddGlobals( PyObject* module ) {
         PyModule_AddStringConstant( module, "__version__", Version() );
+        if( PyType_Ready( &pyQObjectType_ ) == 0 ) {
+            Py_INCREF( &pyQObjectType_ );
+            PyModule_AddObject( module, "QObject", reinterpret_cast< PyObject* >( &pyQObjectType_ ) );
+        }
     }    
+    /// Release memory of unused wrappers; returns number of released wrappers.
+    /// The free list is shared by all contexts and is released by the
+    /// destructor of the last context; call this function before
+    /// @c Py_Finalize when contexts are destroyed after the interpreter.
+    static int ClearFreeList();
+    /// @brief Enable cache of Python strings returned for short QStrings such as
+    /// object names and keys; see qpy::SetStringCacheSize.
+    ///
+    /// The cache is shared by all contexts and disabled by the destructor of
+    /// the last context; it must be reset to zero before @c Py_Finalize when
+    /// contexts are destroyed after the interpreter.
+    static void SetStringCacheSize( int entries ) {
+        qpy::SetStringCacheSize( entries );
+    }
+    /// Return @c true if class or a class derived from it has been added to
+    /// the context.
+    bool IsQObjectClass( const QByteArray& className ) const {
+        return qobjectClasses_.contains( className );
+    }
+    /// Return @c true if object is a QObject wrapper.
+    static bool IsQObject( PyObject* obj ) {
+        return PyObject_TypeCheck( obj, &pyQObjectType_ );
+    }
     /// Add type to Python interpreter; the Qt type is wrapped with a Python class.
     /// Instances are created from within Python by explicilty invoking constructors
     /// mapped to the actual C++ constructors declared as @c Q_INVOKABLE.
@@ -202,11 +414,24 @@ public:
         AddType( &T::staticMetaObject, module, checkConstructor, selectedMembers,
                  mm, className, doc );    
     }
+    /// Enable or disable lazy type creation for types added afterwards.
+    /// Methods and properties of lazy types are added to the Python type
+    /// the first time they are accessed, reducing the time and memory
+    /// required to register types with many members rarely or never accessed
+    /// from Python; note that members not yet accessed are not reported by
+    /// @c dir().
+    void SetLazyTypes( bool lazy ) { lazyTypes_ = lazy; }
+    /// Return @c true if types are created lazily.
+    bool LazyTypes() const { return lazyTypes_; }
     /// Return global functions to be added to Python module.
     /// These are the mainly the functions required for accessing the signal-slot binding
     /// facilities.
     PyMethodDef* ModuleFunctions();
     /// Add pre-existing QObject instance to Python module. 
+    /// The returned wrapper is an instance of the type matching the dynamic
+    /// type of the QObject; QObjects already wrapped are always mapped to the
+    /// same wrapper, in which case ownership is not modified.
+    /// A NULL QObject pointer is mapped to @c None.
     PyObject* AddObject( QObject* qobj, 
                          PyObject* targetModule, // where instance is added 
                          PyObject* typeModule, // where type is defined
@@ -217,28 +442,35 @@ public:
     /// Register new types by passing the type of QArgConstructor and PyArgConstructor;
     /// this way of registering does not allow to pass actual instances, and does require
     /// support for operator new and delete.
+    /// The type name must be known to QMetaType; a single constructor instance
+    /// is created and shared by all the methods using the type.
     template < typename QArgConstructorT, typename PyArgConstructorT > 
     bool RegisterType( const QString& typeName, bool overwrite = false ) {
-        return RegisterType( typeName, new QArgConstructorT, new PyArgConstructorT, overwrite );
+        const QByteArray name = typeName.toAscii();
+        return RegisterType( name, QMetaType::type( name.constData() ),
+                             NewArgConstructor< QArgConstructorT >(), 
+                             NewArgConstructor< PyArgConstructorT >(), overwrite );
     }
     template < typename QArgConstructorT, typename PyArgConstructorT > 
     bool RegisterType( QMetaType::Type t, bool overwrite = false ) {
-        return RegisterType( QMetaType::typeName( t ), 
-                             new QArgConstructorT, new PyArgConstructorT, overwrite );
+        return RegisterType( QMetaType::typeName( t ), t, 
+                             NewArgConstructor< QArgConstructorT >(), 
+                             NewArgConstructor< PyArgConstructorT >(), overwrite );
     }
     /// Register new types by passing the type of QArgConstructor and PyArgConstructor;
     /// this way of registering does not allow to pass actual instances, and does require
-    /// support for operator new and delete. Also register the 
+    /// support for operator new and delete. Also register the type with QMetaType.
     template < typename T, typename QArgConstructorT, typename PyArgConstructorT > 
     bool RegisterType( const QString& typeName, bool overwrite = false ) {
-        return RegisterType( qRegisterMetaType< T >( typeName.toAscii().constData() ),
-                             new QArgConstructorT, new PyArgConstructorT, overwrite );
+        const QByteArray name = typeName.toAscii();
+        return RegisterType( name, qRegisterMetaType< T >( name.constData() ),
+                             NewArgConstructor< QArgConstructorT >(), 
+                             NewArgConstructor< PyArgConstructorT >(), overwrite );
     }
     void RegisterQVariantToPyObject( QVariant::Type t,  QVariantToPyObject* qp ) {
-        if( qvariantToPyObject_.contains( t ) ) {
-            if( !qvariantToPyObject_[ t ]->ForeignOwned() ) delete qvariantToPyObject_[ t ];
-        }
-        qvariantToPyObject_[ t ] = qp;
+        QVariantToPyObject*& c = ConverterSlot( qvariantToPyObject_, t );
+        if( c && !c->ForeignOwned() ) delete c;
+        c = qp;
     }
     template < typename T >
     int RegisterQVariantToPyObject( QVariantToPyObject* qp ) {
@@ -247,20 +479,72 @@ public:
         return id;
     }
     void RegisterPyObjectToQVariant( QVariant::Type t,  PyObjectToQVariant* qp ) {
-        if( pyObjectToQVariant_.contains( t ) ) {
-            if( !pyObjectToQVariant_[ t ]->ForeignOwned() ) delete pyObjectToQVariant_[ t ];
-        }
-        pyObjectToQVariant_[ t ] = qp;
+        PyObjectToQVariant*& c = ConverterSlot( pyObjectToQVariant_, t );
+        if( c && !c->ForeignOwned() ) delete c;
+        c = qp;
+    }
+    /// Return QVariant -> Python converter for meta type id, NULL if not registered.
+    const QVariantToPyObject* FindQVariantToPyObject( int id ) const {
+        return id >= 0 && id < qvariantToPyObject_.size() ? qvariantToPyObject_[ id ] : 0;
+    }
+    /// Return Python -> QVariant converter for meta type id, NULL if not registered.
+    const PyObjectToQVariant* FindPyObjectToQVariant( int id ) const {
+        return id >= 0 && id < pyObjectToQVariant_.size() ? pyObjectToQVariant_[ id ] : 0;
     }
     template < typename T >
     int RegisterPyObjectToQVariant( PyObjectToQVariant* qp ) {
         const int id = qRegisterMetaType< T >();
-        RegisterPyObjectToQVariant( qMetaTypeId< T >, qp );
+        RegisterPyObjectToQVariant( QVariant::Type( id ), qp );
         return id;
     }
+    /// @brief Register all the Python <--> Qt converters for type @c T,
+    /// generated from a converter class: method arguments and return values,
+    /// signal arguments and QVariant conversions used for properties.
+    ///
+    /// Type @c T must be declared with @c Q_DECLARE_METATYPE and the
+    /// converters be registered before adding types which use it; existing
+    /// converters are replaced.
+    /// @code
+    /// struct PointConverter {
+    ///     PyObject* ToPy( const Point& p ) const { ... }
+    ///     bool FromPy( PyObject* obj, Point& p ) const { ... }
+    ///     int Check( PyObject* obj ) const { return PyTuple_Check( obj ) ? 2 : 0; }
+    /// };
+    /// ctx.RegisterConverter< Point, PointConverter >();
+    /// @endcode
+    /// @see PyConverter.h
+    /// @return meta type id of @c T
+    template < typename T, typename ConverterT >
+    int RegisterConverter( const ConverterT& c = ConverterT() ) {
+        return RegisterConverter< T >( c, qMetaTypeId< T >(), true, true );
+    }
+    /// @brief Register all the Python <--> Qt converters for type @c T not
+    /// declared with @c Q_DECLARE_METATYPE; the type is registered with
+    /// QMetaType under the given name, which must match the name used in
+    /// method signatures.
+    /// @return meta type id of @c T
+    template < typename T, typename ConverterT >
+    int RegisterConverter( const char* typeName, const ConverterT& c = ConverterT() ) {
+        return RegisterConverter< T >( c, qRegisterMetaType< T >( typeName ), true, true );
+    }
+    /// @brief Register all the Python <--> Qt converters for type @c T from a pair
+    /// of conversion functions; either function can be NULL if the conversion
+    /// is not available. The optional check function is used to select among
+    /// overloaded methods, see FunctionConverter::Check.
+    /// @return meta type id of @c T
+    template < typename T >
+    int RegisterConverter( typename FunctionConverter< T >::ToPyFunction toPy,
+                           typename FunctionConverter< T >::FromPyFunction fromPy,
+                           typename FunctionConverter< T >::CheckFunction check = 0 ) {
+        return RegisterConverter< T >( FunctionConverter< T >( toPy, fromPy, check ),
+                                       qMetaTypeId< T >(), toPy != 0, fromPy != 0 );
+    }
+    /// Remove converters of type; types already added keep using them.
     void UnRegisterType( const QString& typeName ) {
-        if( !argFactory_.contains( typeName ) ) return;    
-        argFactory_.erase( argFactory_.find( typeName ) );
+        const ArgFactoryEntry* e = FindArgFactoryEntry( typeName.toAscii() );
+        if( !e ) return;
+        typeIds_.remove( e->typeName );
+        argFactory_[ int( e - argFactory_.constData() ) ] = ArgFactoryEntry();
     }
     /// @brief Stores information on registered types.
     /// 
@@ -276,18 +560,14 @@ public:
     /// Return information on registered type.
     /// @param t type name
     TypeConstruction RegTypeInfo( const QString& t ) const {
-        TypeConstruction tc;
-        if( !argFactory_.contains( t ) ) return tc;
-        tc.pyToQt = dynamic_cast< const NoQArgConstructor* >( argFactory_[ t ].QArgCtor() ) == 0;
-        tc.qtToPy = dynamic_cast< const NoPyArgConstructor* >( argFactory_[ t ].PyArgCtor() )  == 0;    
-        tc.typeName = t;
-        return tc;
+        const ArgFactoryEntry* e = FindArgFactoryEntry( t.toAscii() );
+        return e ? RegTypeInfo( *e ) : TypeConstruction();
     }
     /// Return list of registered types 
     QList< TypeConstruction > RegisteredTypes() const {
         QList< TypeConstruction > tc;
         for( ArgFactory::const_iterator i = argFactory_.begin(); i != argFactory_.end(); ++i ) {
-            tc.push_back( RegTypeInfo( i.key() ) );
+            if( i->qac || i->pac ) tc.push_back( RegTypeInfo( *i ) );
         }
         return tc;
     }
@@ -300,54 +580,141 @@ private:
     /// returned by @c QMetaMethod::parameterTypes().
     QArgWrappers GenerateQArgWrappers( const ArgumentTypes& at );
     /// @brief Create PyArgWrapper instance from type name.
-    PyArgWrapper GeneratePyArgWrapper( QString typeName );
+    PyArgWrapper GeneratePyArgWrapper( const QByteArray& typeName );
+    /// @brief Create PyArgWrapper returning a lazy view for QVariant containers,
+    /// same as GeneratePyArgWrapper for other types.
+    PyArgWrapper GenerateViewWrapper( const QByteArray& typeName );
+    /// @brief Add new overload set to type and return the matching
+    /// descriptor definition.
+    PyGetSetDef AddOverloads( Type& t, const std::string& name, const char* doc );
+    /// @brief Create method wrapper; throws if argument or return types
+    /// are unknown.
+    Method NewMethod( const Type& t, int methodIndex );
+    /// @brief Add method to type and overload set.
+    void AddMethod( Type& t, Overloads& overloads, int methodIndex );
+    /// @brief Return descriptor definition for property.
+    PyGetSetDef AddProperty( Type& t, const std::string& name, const char* doc,
+                             int propertyIndex );
+    /// @brief Add lazy member to Python type; returns @c false if member
+    /// not found or not added.
+    bool MaterializeMember( Type& t, const QByteArray& name );
 private:
-    class ArgFactoryEntry {
-    public:
-        ArgFactoryEntry() : qac_( 0 ), pac_( 0 ) {}
-        ArgFactoryEntry( const ArgFactoryEntry& fe ) 
-            : typeName_( fe.typeName_ ), qac_( 0 ), pac_( 0 ) {
-                if( fe.qac_ ) qac_ = fe.qac_->Clone();
-                if( fe.pac_ ) pac_ = fe.pac_->Clone();
-        }
-        ArgFactoryEntry( const QString& tn, QArgConstructor* qac, PyArgConstructor* pac )
-            : typeName_( tn ), qac_( qac ), pac_( pac ) {}
-        const ArgFactoryEntry& operator=( const ArgFactoryEntry& fe ) {
-            typeName_ = fe.typeName_;
-            qac_ = fe.qac_ ? fe.qac_->Clone() : 0;
-            pac_ = fe.pac_ ? fe.pac_->Clone() : 0;
-            return *this;
-        }    
-        ~ArgFactoryEntry() {
-            delete qac_;
-            delete pac_;
-        }
-        const QArgConstructor* QArgCtor() const { return qac_; }
-        const PyArgConstructor* PyArgCtor() const { return pac_; }
-        QArgConstructor* MakeQArgConstructor() const { return qac_->Clone(); }
-        PyArgConstructor* MakePyArgConstructor() const { return pac_->Clone(); }
-        const QString& TypeName() const { return typeName_; }
-    private:
-        QString typeName_;
-        QArgConstructor* qac_;
-        PyArgConstructor* pac_;
+    /// @brief Converters registered for a type.
+    ///
+    /// Converters are never modified after registration and are shared by all
+    /// the wrappers; they are owned by the context and deleted at destruction
+    /// time only, since wrappers of existing types keep referencing converters
+    /// replaced or unregistered afterwards.
+    struct ArgFactoryEntry {
+        QByteArray typeName;
+        /// Python -> Qt constructor; NULL if conversion not available
+        const QArgConstructor* qac;
+        /// Qt -> Python constructor; NULL if conversion not available
+        const PyArgConstructor* pac;
+        ArgFactoryEntry() : qac( 0 ), pac( 0 ) {}
     };
-    typedef QMap< QString, ArgFactoryEntry > ArgFactory;
-    bool RegisterType( const QString& typeName, QArgConstructor* qac, PyArgConstructor* pac, bool overwrite ) {
-        const bool typeExist = argFactory_.contains( typeName );
-        if( typeExist && !overwrite ) return false;
-        argFactory_[ typeName ] = ArgFactoryEntry( typeName, qac, pac );
+    /// Converters indexed by meta type id
+    typedef QVector< ArgFactoryEntry > ArgFactory;
+    bool RegisterType( const QByteArray& typeName, int id,
+                       QArgConstructor* qac, PyArgConstructor* pac, bool overwrite ) {
+        if( qac ) qArgConstructors_.push_back( qac );
+        if( pac ) pyArgConstructors_.push_back( pac );
+        // 0 is returned by QMetaType::type for unknown types
+        if( id < 0 || ( id == QMetaType::Void && typeName != QMetaType::typeName( id ) ) ) {
+            return false;
+        }
+        if( id >= argFactory_.size() ) argFactory_.resize( id + 1 );
+        ArgFactoryEntry& e = argFactory_[ id ];
+        if( ( e.qac || e.pac ) && !overwrite ) return false;
+        e.typeName = typeName;
+        e.qac = qac;
+        e.pac = pac;
+        typeIds_[ typeName ] = id;
         return true; 
     }
-    Type* ExistingType( const QMetaObject* mo, PyObject* module ) {
-        for( Types::iterator i = types_.begin(); i != types_.end(); ++i ) {
-            if( i->metaObject->className() == mo->className() && 
-                i->pyModule == module ) return &( *i );
+    /// Return converters registered for type name, NULL if not registered.
+    const ArgFactoryEntry* FindArgFactoryEntry( const QByteArray& typeName ) const {
+        int id = typeIds_.value( typeName, -1 );
+        // type aliases are not stored in the name map
+        if( id < 0 ) id = QMetaType::type( typeName.constData() );
+        if( id <= 0 && typeName != QMetaType::typeName( QMetaType::Void ) ) return 0;
+        if( id >= argFactory_.size() ) return 0;
+        const ArgFactoryEntry* e = &argFactory_[ id ];
+        return e->qac || e->pac ? e : 0;
+    }
+    static TypeConstruction RegTypeInfo( const ArgFactoryEntry& e ) {
+        TypeConstruction tc;
+        tc.pyToQt = e.qac != 0;
+        tc.qtToPy = e.pac != 0;
+        tc.typeName = e.typeName;
+        return tc;
+    }
+    template < typename T, typename ConverterT >
+    int RegisterConverter( const ConverterT& c, int id, bool toPy, bool fromPy ) {
+        QArgConstructor* qac = fromPy ? new ConverterQArgConstructor< T, ConverterT >( c ) : 0;
+        PyArgConstructor* pac = toPy ? new ConverterPyArgConstructor< T, ConverterT >( c, id ) : 0;
+        RegisterType( QMetaType::typeName( id ), id, qac, pac, true );
+        if( toPy ) {
+            RegisterQVariantToPyObject( QVariant::Type( id ), 
+                                        new ConverterQVariantToPyObject< T, ConverterT >( c, id ) );
+        }
+        if( fromPy ) {
+            RegisterPyObjectToQVariant( QVariant::Type( id ),
+                                        new ConverterPyObjectToQVariant< T, ConverterT >( c, id ) );
         }
-        return 0;    
+        return id;
+    }
+    /// @brief Register converters for pointers to type and base types, if not
+    /// already registered, and record type and base types as QObject classes.
+    void RegisterQObjectPointers( const QMetaObject* mo );
+    /// @brief Register converters for pointer type @c Class*; pointer types
+    /// not known to QMetaType are registered with QMetaType.
+    /// @return registered entry, NULL if registration not possible
+    const ArgFactoryEntry* RegisterQObjectPointer( const QByteArray& typeName );
+    /// @brief Return converters registered for type name; pointers to classes
+    /// not registered yet are registered as pointers to QObject-derived types,
+    /// to allow types to reference types added afterwards.
+    const ArgFactoryEntry* ResolveArgFactoryEntry( const QByteArray& typeName );
+    /// Register constructor of lazy views returned by methods selected through
+    /// PyMemberNameMapper::returnView.
+    template < typename T > void RegisterVariantView() {
+        const int id = qMetaTypeId< T >();
+        PyArgConstructor* pac = new ConverterPyArgConstructor< T, VariantViewConverter< T > >(
+            VariantViewConverter< T >( VariantConverter( this ) ), id );
+        pyArgConstructors_.push_back( pac );
+        if( id >= viewArgConstructors_.size() ) viewArgConstructors_.resize( id + 1 );
+        viewArgConstructors_[ id ] = pac;
+    }
+    /// Register converters for @c QVector and @c QList of numeric type.
+    template < typename T > void RegisterNumericContainers( const char* elementName ) {
+        RegisterNumericContainers< T, NumericContainerConverter< QVector< T >, T > >( elementName );
+    }
+    /// Register converters for @c QVector and @c QList of numeric type, @c QVector
+    /// converted through VectorConverterT.
+    template < typename T, typename VectorConverterT >
+    void RegisterNumericContainers( const char* elementName ) {
+        const QByteArray vectorName = QByteArray( "QVector<" ) + elementName + ">";
+        const QByteArray listName = QByteArray( "QList<" ) + elementName + ">";
+        RegisterConverter< QVector< T >, VectorConverterT >( vectorName.constData() );
+        RegisterConverter< QList< T >, NumericContainerConverter< QList< T >, T > >(
+            listName.constData() );
+    }
+    Type* ExistingType( const QMetaObject* mo, PyObject* module ) const {
+        return typeIndex_.value( TypeKey( mo, module ), 0 );
+    }
+    /// QVariant converters indexed by meta type id, NULL if not registered
+    typedef QVector< QVariantToPyObject* > QVariantToPyObjectMapType;
+    typedef QVector< PyObjectToQVariant* > PyObjectToQVariantMapType;    
+    /// Return reference to element @c id, growing table if needed.
+    template < typename T >
+    static T*& ConverterSlot( QVector< T* >& table, int id ) {
+        const int size = table.size();
+        if( id >= size ) {
+            table.resize( id + 1 );
+            for( int i = size; i != id + 1; ++i ) table[ i ] = 0;
+        }
+        return table[ id ];
     }
-    typedef QMap< QVariant::Type, QVariantToPyObject* > QVariantToPyObjectMapType;
-    typedef QMap< QVariant::Type, PyObjectToQVariant* > PyObjectToQVariantMapType;    
 private:
     static PyObject* PyQObjectConnect( PyObject* self, PyObject* args );
     static PyObject* PyQObjectDisconnect( PyObject* self, PyObject* args );
@@ -356,33 +723,82 @@ private:
     static PyObject* PyQObjectAcquire( PyObject* self, PyObject* args );
     static PyObject* PyQObjectRelease( PyObject* self, PyObject* args );
     static PyObject* PyQObjectPtr( PyObject* self, PyObject* args );
-    static PyObject* PyQObjectGetter( PyQObject* qobj, void* closure /*method id*/ );
-    static int PyQObjectSetter( PyQObject*, PyObject*, void* closure );
+    static PyObject* PyQObjectPropertySet( PyObject* self, PyObject* args );
+    static PyObject* PyQObjectGetProperties( PyObject* self, PyObject* args );
+    static PyObject* PyQObjectSetProperties( PyObject* self, PyObject* args );
+    static PyObject* PyQObjectGather( PyObject* self, PyObject* args );
+    static PyObject* PyQObjectScatter( PyObject* self, PyObject* args );
+    static const Property* GatherProperty( PyObject* obj, PyObject* name,
+                                           Type*& type, const Property*& p );
+    static char ArrayTypeCode( const Property& p );
+    static int ArrayItemSize( char typeCode );
+    static int MetacallWriteProperty( QObject* obj, const Property& p, void* value );
+    static void PyQPropertySetDealloc( PyQPropertySet* self );
+    static const Property* FindProperty( Type& t, PyObject* name );
+    static PyQPropertySet* ResolveProperties( Type& t, PyObject* names );
+    static PyObject* PyQObjectMethodGetter( PyQObject* qobj, void* closure /*Overloads*/ );
+    static int PyQObjectMethodSetter( PyQObject*, PyObject*, void* closure );
+    static PyObject* PyQObjectPropertyGetter( PyQObject* qobj, void* closure /*Property*/ );
+    static int PyQObjectPropertySetter( PyQObject*, PyObject*, void* closure );
+    static PyObject* PyQObjectGetAttr( PyObject* self, PyObject* name );
+    static int PyQObjectSetAttr( PyObject* self, PyObject* name, PyObject* value );
     static PyObject* PyQObjectNew( PyTypeObject* type, PyObject*, PyObject* );
-    static PyObject* PyQObjectInvokeMethod( PyQObject* self, PyObject* args );
+    static PyObject* PyQObjectInvokeMethod( PyQObject* self, const Method& m, PyObject* args );
+    static PyObject* InvokeMethod( PyQObject* self, const Method& m, PyObject* args,
+                                   CallFrame& frame );
+    static PyObject* PyQObjectInvokeMany( PyObject* self, PyObject* args );
+    static PyObject* PyQObjectConstructMany( PyObject* self, PyObject* args );
+    static int ConstructQObject( PyQObject* self, const Method& ctor, PyObject* args,
+                                 CallFrame& frame );
+    static PyObject* ReadProperty( PyQObject* self, const Property& p );
+    static int WriteProperty( PyQObject* self, const Property& p, PyObject* value );
+    static int WriteProperties( PyQObject* self, const QVector< const Property* >& props,
+                                PyObject* const* values );
+    static PyObject* PyQMethodCall( PyQMethod* self, PyObject* args, PyObject* kwds );
+    static void PyQMethodDealloc( PyQMethod* self );
     static int PyQObjectInit( PyQObject* self, PyObject* args, PyObject* kwds );
     static PyObject* PyQObjectTr( PyObject* self, PyObject* args );
     static void PyQObjectDealloc( PyQObject* self );
 private:
     PyTypeObject CreatePyType( const Type& type );
-    struct ConnectEntry {
-        PyQObject* pyqobj;
-        int methodId;
-        ConnectEntry() : pyqobj( 0 ), methodId( -1 ) {}
-        ConnectEntry( PyQObject* p, int m ) : pyqobj( p ), methodId( m ) {}
-    };
-    typedef QList< ConnectEntry > ConnectList;
 private:
     /// @brief QObject-Method database: Each QObject is stored together with the list
     /// of associated method signatures
     Types types_;
+    /// Index of registered types, used by @c AddType and @c AddObject
+    TypeIndex typeIndex_;
     PyCallbackDispatcher dispatcher_;
+    /// Converters indexed by meta type id
     ArgFactory argFactory_;
+    /// Registered type name -> meta type id
+    QHash< QByteArray, int > typeIds_;
+    /// Names of the classes of added types and of their base classes
+    QSet< QByteArray > qobjectClasses_;
+    /// All registered converters, deleted at destruction time
+    QList< const QArgConstructor* > qArgConstructors_;
+    QList< const PyArgConstructor* > pyArgConstructors_;
+    /// Lazy view constructors indexed by meta type id
+    QVector< const PyArgConstructor* > viewArgConstructors_;
     QVariantToPyObjectMapType qvariantToPyObject_;
     PyObjectToQVariantMapType pyObjectToQVariant_;
-    static ConnectList endpoints_; //thread_local if needed
-    static int getterMethodId_;
-    static bool signal_;
+    /// QObject -> wrapper map
+    WrapperCache wrapperCache_;
+    /// Create types lazily
+    bool lazyTypes_;
+    /// Python type of bound methods
+    static PyTypeObject pyQMethodType_;
+    /// Base Python type of all QObject wrapper types
+    static PyTypeObject pyQObjectType_;
+    /// Python type of property sets
+    static PyTypeObject pyQPropertySetType_;
+    /// Maximum number of deallocated wrappers kept for reuse
+    enum { MAX_FREE_WRAPPERS = 1024 };
+    /// Deallocated wrappers, linked through the @c obj field
+    static PyQObject* freeList_;
+    /// Number of wrappers in free list
+    static int numFree_;
+    /// Number of existing contexts
+    static int numContexts_;
 };
 
 }
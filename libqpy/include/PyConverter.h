@@ -0,0 +1,178 @@
+#pragma once
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief Converters for all the Python <--> Qt conversion directions of a
+/// type, generated from a single converter class.
+///
+/// A converter class for type @c T implements:
+/// - <tt>PyObject* ToPy( const T& ) const</tt>: return a new reference or NULL
+///   with a Python exception set
+/// - <tt>bool FromPy( PyObject*, T& ) const</tt>: return @c false with a Python
+///   exception set in case of conversion error
+/// - <tt>int Check( PyObject* ) const</tt>: same as QArgConstructor::Check()
+///
+/// The converter is stored by value inside the generated constructors, and its
+/// members are invoked directly: conversions implemented by stateless converter
+/// classes with inline members are expanded in place.
+/// @see PyContext::RegisterConverter
+
+#include <Python.h>
+#include <new>
+#include <QMetaType>
+#include <QVariant>
+
+#include "PyQArgConstructor.h"
+#include "PyArgConstructor.h"
+#include "PyQVariantToPyObject.h"
+#include "PyObjectToQVariant.h"
+
+namespace qpy {
+
+/// @brief Converter class wrapping a pair of conversion functions and an
+/// optional type check function.
+///
+/// Either conversion function can be NULL when the corresponding conversion
+/// is not available.
+template < typename T >
+class FunctionConverter {
+public:
+    /// Qt -> Python conversion function.
+    typedef PyObject* ( *ToPyFunction )( const T& );
+    /// Python -> Qt conversion function.
+    typedef bool ( *FromPyFunction )( PyObject*, T& );
+    /// Type check function used for overload resolution: returns 2 for
+    /// exact match, 1 if conversion available, 0 otherwise.
+    typedef int ( *CheckFunction )( PyObject* );
+    /// Constructor.
+    FunctionConverter( ToPyFunction toPy = 0, FromPyFunction fromPy = 0,
+                       CheckFunction check = 0 )
+        : toPy_( toPy ), fromPy_( fromPy ), check_( check ) {}
+    PyObject* ToPy( const T& v ) const { return toPy_( v ); }
+    bool FromPy( PyObject* pyobj, T& v ) const { return fromPy_( pyobj, v ); }
+    /// Without a check function no Python object is reported as matching:
+    /// methods taking @c T are invoked only when no other overload with the
+    /// same number of arguments exists.
+    int Check( PyObject* pyobj ) const { return check_ ? check_( pyobj ) : 0; }
+private:
+    ToPyFunction toPy_;
+    FromPyFunction fromPy_;
+    CheckFunction check_;
+};
+
+/// QArgConstructor generated from converter class.
+template < typename T, typename ConverterT >
+class ConverterQArgConstructor : public QArgConstructor {
+public:
+    ConverterQArgConstructor( const ConverterT& c = ConverterT() ) : c_( c ) {}
+    /// Default-construct value into per-call storage and convert PyObject.
+    void* Construct( PyObject* pyobj, void* storage ) const {
+        T* p = new ( storage ) T;
+        if( c_.FromPy( pyobj, *p ) ) return p;
+        p->~T();
+        return 0;
+    }
+    size_t StorageSize() const { return sizeof( T ); }
+    void Destroy( void* p ) const { reinterpret_cast< T* >( p )->~T(); }
+    int Check( PyObject* pyobj ) const { return c_.Check( pyobj ); }
+    ConverterQArgConstructor* Clone() const {
+        return new ConverterQArgConstructor( *this );
+    }
+private:
+    ConverterT c_;
+};
+
+/// PyArgConstructor generated from converter class.
+template < typename T, typename ConverterT >
+class ConverterPyArgConstructor : public PyArgConstructor {
+public:
+    /// Constructor.
+    /// @param c converter
+    /// @param type meta type id of @c T; the default requires @c T to be declared
+    ///        with @c Q_DECLARE_METATYPE
+    ConverterPyArgConstructor( const ConverterT& c = ConverterT(), int type = qMetaTypeId< T >() )
+        : c_( c ), type_( type ) {}
+    PyObject* Create( void* p ) const {
+        return c_.ToPy( *reinterpret_cast< const T* >( p ) );
+    }
+    size_t StorageSize() const { return sizeof( T ); }
+    void* Construct( void* storage ) const { return new ( storage ) T; }
+    void Destroy( void* p ) const { reinterpret_cast< T* >( p )->~T(); }
+    ConverterPyArgConstructor* Clone() const {
+        return new ConverterPyArgConstructor( *this );
+    }
+    bool IsQObjectPtr() const { return false; }
+    QMetaType::Type Type() const { return QMetaType::Type( type_ ); }
+private:
+    ConverterT c_;
+    int type_;
+};
+
+/// QVariantToPyObject generated from converter class.
+template < typename T, typename ConverterT >
+struct ConverterQVariantToPyObject : QVariantToPyObject {
+    /// Constructor.
+    /// @param c converter
+    /// @param type meta type id of @c T
+    /// @param f foreign owned
+    ConverterQVariantToPyObject( const ConverterT& c, int type, bool f = false )
+        : QVariantToPyObject( f ), c_( c ), type_( type ) {}
+    PyObject* Create( const QVariant& v ) const {
+        // no copy when the QVariant stores the exact type
+        if( v.userType() == type_ ) {
+            return c_.ToPy( *reinterpret_cast< const T* >( v.constData() ) );
+        }
+        QVariant cv( v );
+        if( !cv.convert( QVariant::Type( type_ ) ) ) {
+            PyErr_SetString( PyExc_TypeError, "QVariant conversion not available" );
+            return 0;
+        }
+        return c_.ToPy( *reinterpret_cast< const T* >( cv.constData() ) );
+    }
+private:
+    ConverterT c_;
+    int type_;
+};
+
+/// PyObjectToQVariant generated from converter class.
+template < typename T, typename ConverterT >
+struct ConverterPyObjectToQVariant : PyObjectToQVariant {
+    /// Constructor.
+    /// @param c converter
+    /// @param type meta type id of @c T
+    /// @param f foreign owned
+    ConverterPyObjectToQVariant( const ConverterT& c, int type, bool f = false )
+        : PyObjectToQVariant( f ), c_( c ), type_( type ) {}
+    QVariant Create( PyObject* pyobj ) const {
+        T v;
+        if( !c_.FromPy( pyobj, v ) ) return QVariant();
+        return QVariant( type_, &v );
+    }
+private:
+    ConverterT c_;
+    int type_;
+};
+}
@@ -45,6 +45,10 @@ struct PyMemberNameMapper {
     virtual const char* propertyDoc( const QString& name ) const = 0;
     /// Return dicumentation string for method
     virtual const char* methodDoc( const QString& sig ) const = 0;
+    /// @brief Return @c true to have method return a lazy view instead of
+    /// converting the returned QVariantList, QVariantMap or QVariantHash;
+    /// elements are converted when accessed from Python.
+    virtual bool returnView( const QString& /*sig*/ ) const { return false; }
     /// Virtual destructor
     virtual ~PyMemberNameMapper() {} 
 };
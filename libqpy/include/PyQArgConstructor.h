@@ -37,12 +37,39 @@ namespace qpy {
 /// PyObjects. 
 ///
 /// There shall be exactly one and only one constructor per C++ type.
-/// The QPy run-time (indirectly) invokes the QArgConstructor::Create() 
+/// The QPy run-time (indirectly) invokes the QArgConstructor::Construct() 
 /// method whenever the invocation of a method of a QObject derived 
-/// class instance is requested from Python code. 
+/// class instance is requested from Python code.
+///
+/// Values are created into per-call storage provided by the run-time, of
+/// size QArgConstructor::StorageSize(); constructors which do not
+/// override QArgConstructor::Construct() store the value into the
+/// constructor instance itself through the QArgConstructor::Create() method:
+/// such constructors are not reentrant.
 struct QArgConstructor {
-    /// Create a QGenericArgument from Python values.
-    virtual QGenericArgument Create( PyObject* ) const = 0;
+    /// Create a QGenericArgument from Python values; the returned argument
+    /// references data stored inside the constructor instance.
+    virtual QGenericArgument Create( PyObject* ) const {
+        throw std::logic_error( "QArgConstructor::Create not implemented" );
+        return QGenericArgument();
+    }
+    /// Size in bytes of the storage required by Construct(); zero if the
+    /// value is stored into the constructor instance.
+    virtual size_t StorageSize() const { return 0; }
+    /// Create value from PyObject into memory area of StorageSize() bytes.
+    /// @return address of created value or NULL if conversion failed, in which
+    ///         case a Python exception is set
+    virtual void* Construct( PyObject* pyobj, void* /*storage*/ ) const {
+        return Create( pyobj ).data();
+    }
+    /// Destroy value created by Construct().
+    virtual void Destroy( void* ) const {}
+    /// @brief Check type of PyObject; used to select among overloaded methods.
+    ///
+    /// Implementations shall only perform cheap checks on the Python type.
+    /// @return 0 if PyObject cannot be converted, 1 if it can be converted,
+    ///         2 if the PyObject type is the Python equivalent of the C++ type
+    virtual int Check( PyObject* ) const { return 1; }
     /// Virtual destructor.
     virtual ~QArgConstructor() {}
     /// Create a new instance of the current class.
@@ -31,6 +31,8 @@
 /// Each wrapper instance wraps a constructor of a specific type matching
 /// the argument in a function/method signature.
 #include <Python.h>
+#include <cassert>
+#include <QVarLengthArray>
 #include "../PyQArgConstructor.h"
 #include "../PyArgConstructor.h"
 
@@ -41,19 +43,16 @@ namespace qpy {
 /// method is translated to an index and a list of QArgWrapper objects 
 /// stored inside a PyContext instance.
 /// At invocation time the proper method is invoked through a call to
-/// @c QMetaMethod::invoke passing the arguments returned by the QArgWrapper::Arg
+/// @c qt_metacall passing the arguments created by the QArgWrapper::Construct
 /// method invoked on each parameter in the argument list.
-/// QArgWrapper stores an instance of QArgConstructor used to create a
-/// QGenericArgument from PyObjects.
+/// QArgWrapper references the QArgConstructor used to create
+/// C++ values from PyObjects; constructors are shared among wrappers and owned
+/// by the PyContext instance.
 class QArgWrapper {
 public:
     /// @brief Default constructor.
-    QArgWrapper( QArgConstructor* ac = 0 ) : ac_( ac ) {
+    QArgWrapper( const QArgConstructor* ac = 0 ) : ac_( ac ) {
 
-    }
-    /// Copy constructor: Clone QArgConstructor instance.
-    QArgWrapper( const QArgWrapper& other ) : ac_( 0 ) {
-        if( other.ac_ ) ac_ = other.ac_->Clone();
     }
     /// @brief Return QGenericArgument instance created from PyObjects
     ///
@@ -62,12 +61,21 @@ public:
     QGenericArgument Arg( PyObject* pobj ) const {
         return ac_ ? ac_->Create( pobj ) : QGenericArgument();
     }
-    /// @brief Destructor; delete QArgConstructor instance.
-    ~QArgWrapper() { delete ac_; }
+    /// @brief Create value from PyObject into per-call storage.
+    /// @return address of value or NULL in case of conversion error
+    void* Construct( PyObject* pobj, void* storage ) const {
+        return ac_->Construct( pobj, storage );
+    }
+    /// Destroy value created by Construct.
+    void Destroy( void* p ) const { ac_->Destroy( p ); }
+    /// Size of storage required by Construct.
+    size_t StorageSize() const { return ac_ ? ac_->StorageSize() : 0; }
+    /// Check if PyObject can be converted: 0 = no, 1 = yes, 2 = exact match.
+    int Check( PyObject* pobj ) const { return ac_->Check( pobj ); }
 private:
-    /// Instance of QArgConstructor created from type information at construction
+    /// Instance of QArgConstructor selected from type information at construction
     /// time.
-    QArgConstructor* ac_;    
+    const QArgConstructor* ac_;    
 };
 
 
@@ -80,12 +88,9 @@ private:
 /// an emitted signal.
 class PyArgWrapper {
 public:
-    ///@brief Default constructor.
-    PyArgWrapper( PyArgConstructor* pac = 0 ) : ac_( pac ) {}
-    ///@brief Copy constructor: Clones the internal Return constructor instance.
-    PyArgWrapper( const PyArgWrapper& other ) : ac_( 0 ) {
-        if( other.ac_ ) ac_ = other.ac_->Clone();
-    }
+    ///@brief Default constructor; the PyArgConstructor instance is shared
+    /// among wrappers and owned by the PyContext instance.
+    PyArgWrapper( const PyArgConstructor* pac = 0 ) : ac_( pac ) {}
     /// @brief return values stored in the inner PyArgConstructor.
     ///
     /// This is the method invoked to return values from a QObject method invocation.
@@ -101,6 +106,13 @@ public:
     }
     /// @brief return placeholder for storing Qt return argument
     QGenericReturnArgument Arg() const { return ac_->Argument(); }
+    /// @brief Create placeholder for storing Qt return argument into
+    /// per-call storage; returns NULL for @c void.
+    void* Construct( void* storage ) const { return ac_->Construct( storage ); }
+    /// Destroy placeholder created by Construct.
+    void Destroy( void* p ) const { ac_->Destroy( p ); }
+    /// Size of storage required by Construct.
+    size_t StorageSize() const { return ac_ ? ac_->StorageSize() : 0; }
     /// Type name.
     QString Type() const { 
         if( ac_ != 0 ) return QMetaType::typeName( ac_->Type() );
@@ -114,10 +126,95 @@ public:
     /// because custom registered objects derived from QObject do not have
     /// a QMetaType::QObjectStar type. 
     bool IsQObjectPtr() const { return ac_->IsQObjectPtr(); }
-    /// Delete PyArgConstructor instance.
-    ~PyArgWrapper() { delete ac_; }
 private:
-    /// PyArgConstructor instance created at construction time.
-    PyArgConstructor* ac_;
+    /// PyArgConstructor instance selected at construction time.
+    const PyArgConstructor* ac_;
+};
+
+/// @brief Per-call argument frame.
+///
+/// Holds the argument array passed to @c qt_metacall: return value placeholder
+/// followed by the arguments, and the storage for the values converted from
+/// Python. Storage is allocated on the stack for small signatures and values are
+/// destroyed when the frame goes out of scope; each invocation uses its own
+/// frame, which makes nested and concurrent invocations of the same method safe.
+class CallFrame {
+public:
+    /// Round up storage size to preserve alignment of the next value.
+    static int AlignedSize( size_t s ) {
+        return int( ( s + sizeof( qint64 ) - 1 ) / sizeof( qint64 ) * sizeof( qint64 ) );
+    }
+    /// Constructor.
+    /// @param arity number of arguments
+    /// @param storageSize size in bytes of the storage for all the values, sum
+    ///        of AlignedSize() applied to each wrapper's StorageSize()
+    CallFrame( int arity, int storageSize )
+        : argv_( arity + 1 ), wrappers_( arity ),
+          storage_( storageSize / int( sizeof( qint64 ) ) ),
+          offset_( 0 ), argc_( 0 ), returnWrapper_( 0 ) {
+        argv_[ 0 ] = 0;
+    }
+    /// Convert PyObject and append value to argument array.
+    /// @return @c false in case of conversion error
+    bool PushArg( const QArgWrapper& aw, PyObject* pobj ) {
+        void* p = aw.Construct( pobj, Storage( aw.StorageSize() ) );
+        if( !p ) return false;
+        wrappers_[ argc_ ] = &aw;
+        argv_[ ++argc_ ] = p;
+        return true;
+    }
+    /// Create placeholder for return value.
+    void* SetReturn( const PyArgWrapper& rw ) {
+        returnWrapper_ = &rw;
+        argv_[ 0 ] = rw.Construct( Storage( rw.StorageSize() ) );
+        return argv_[ 0 ];
+    }
+    /// Address of i-th argument.
+    void* Arg( int i ) const { return argv_[ i + 1 ]; }
+    /// Address of return value placeholder.
+    void* Return() const { return argv_[ 0 ]; }
+    /// Argument array to pass to @c qt_metacall.
+    void** Argv() { return argv_.data(); }
+    /// Destroy values and prepare frame for a new invocation, reusing the
+    /// already allocated memory when large enough.
+    void Reset( int arity, int storageSize ) {
+        Clear();
+        argv_.resize( arity + 1 );
+        wrappers_.resize( arity );
+        storage_.resize( storageSize / int( sizeof( qint64 ) ) );
+        argv_[ 0 ] = 0;
+        offset_ = 0;
+    }
+    /// Destroy values in reverse order of creation.
+    ~CallFrame() { Clear(); }
+private:
+    void Clear() {
+        while( argc_ ) {
+            wrappers_[ argc_ - 1 ]->Destroy( argv_[ argc_ ] );
+            --argc_;
+        }
+        if( returnWrapper_ && argv_[ 0 ] ) returnWrapper_->Destroy( argv_[ 0 ] );
+        returnWrapper_ = 0;
+    }
+    void* Storage( size_t size ) {
+        void* p = reinterpret_cast< char* >( storage_.data() ) + offset_;
+        offset_ += AlignedSize( size );
+        assert( offset_ <= storage_.size() * int( sizeof( qint64 ) ) );
+        return p;
+    }
+private:
+    CallFrame( const CallFrame& );
+    CallFrame& operator=( const CallFrame& );
+private:
+    /// ten arguments plus return value
+    static const int PREALLOC_ARGS = 11;
+    /// 256 bytes
+    static const int PREALLOC_STORAGE = 32;
+    QVarLengthArray< void*, PREALLOC_ARGS > argv_;
+    QVarLengthArray< const QArgWrapper*, PREALLOC_ARGS > wrappers_;
+    QVarLengthArray< qint64, PREALLOC_STORAGE > storage_;
+    int offset_;
+    int argc_;
+    const PyArgWrapper* returnWrapper_;
 };
-}
\ No newline at end of file
+}
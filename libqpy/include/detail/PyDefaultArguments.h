@@ -30,237 +30,294 @@
 
 #include <Python.h>
 #include <stdexcept>
+#include <new>
 #include <QString>
 #include <QVariantMap>
 #include <QVariantList>
 #include <QString>
 #include <QList>
+#include <QHash>
 #include <QGenericArgument>
 #include <QGenericReturnArgument>
 #include <QVector>
 #include <QVariant>
+#include <QByteArray>
 
 #include "../PyQArgConstructor.h"
 #include "../PyArgConstructor.h"
+#include "PyStringConversion.h"
 
 /// QPy namespace
 namespace qpy {
 
+class PyContext;
+
 
 /// QArgConstructor implementation for @c integer type.
 class IntQArgConstructor : public QArgConstructor {
 public:
-    /// @brief create an @c integer value from a PyObject then create 
-    /// QGenericArgument referencing the data member.
+    /// @brief create an @c integer value from a PyObject into per-call storage.
     /// @param pyobj pointer to PyObject
-    /// @return QGenericArgument instance whose @c data field points
-    ///         to a private data member of this class' instance
-    QGenericArgument Create( PyObject* pyobj ) const {
-        i_ = PyInt_AsLong( pyobj );
-        return Q_ARG( int, i_ );
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const {
+        const long i = PyInt_AsLong( pyobj );
+        if( i == -1 && PyErr_Occurred() ) return 0;
+        return new ( storage ) int( i );
+    }
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( int ); }
+    /// Accept Python integers.
+    int Check( PyObject* pyobj ) const {
+        return PyInt_Check( pyobj ) || PyLong_Check( pyobj ) ? 2 : 0;
     }
     /// Make copy through copy constructor.
     IntQArgConstructor* Clone() const {
         return new IntQArgConstructor( *this );
     }
-private:
-    /// Storage for value read from Python.
-    mutable int i_;
 };
 /// QArgConstructor implementation for @c QString type.
 class StringQArgConstructor : public QArgConstructor {
 public:
-    /// @brief create a @c QString value from a PyObject then create 
-    /// QGenericArgument referencing the data member.
+    /// @brief create a @c QString value from a PyObject into per-call storage.
     /// @param pyobj pointer to PyObject
-    /// @return QGenericArgument instance whose @c data field points
-    ///         to a private data member of this class' instance
-    QGenericArgument Create( PyObject* pyobj ) const {
-        s_ = PyString_AsString( pyobj );
-        return Q_ARG( QString, s_ );
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const {
+        QString* s = new ( storage ) QString;
+        if( PyToString( pyobj, *s ) ) return s;
+        s->~QString();
+        return 0;
+    }
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( QString ); }
+    /// Accept Python strings and unicode.
+    int Check( PyObject* pyobj ) const {
+        return PyString_Check( pyobj ) || PyUnicode_Check( pyobj ) ? 2 : 0;
+    }
+    /// Destroy QString created by Construct.
+    void Destroy( void* p ) const {
+        reinterpret_cast< QString* >( p )->~QString();
     }
     /// Make copy through copy constructor.
     StringQArgConstructor* Clone() const {
         return new StringQArgConstructor( *this );
     }
-private:
-    /// Storage for value read from Python.
-    mutable QString s_;
 };
-/// QArgConstructor implementation for @c QString type.
+/// QArgConstructor implementation for @c double type.
 class DoubleQArgConstructor : public QArgConstructor {
 public:
-    /// @brief create a @c double value from a PyObject then create 
-    /// QGenericArgument referencing the data member.
+    /// @brief create a @c double value from a PyObject into per-call storage.
     /// @param pyobj pointer to PyObject
-    /// @return QGenericArgument instance whose @c data field points
-    ///         to a private data member of this class' instance
-    QGenericArgument Create( PyObject* pyobj ) const {
-        d_ = PyFloat_AsDouble( pyobj );
-        return Q_ARG( double, d_ );
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const {
+        const double d = PyFloat_AsDouble( pyobj );
+        if( d == -1.0 && PyErr_Occurred() ) return 0;
+        return new ( storage ) double( d );
+    }
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( double ); }
+    /// Accept Python floats and integers.
+    int Check( PyObject* pyobj ) const {
+        if( PyFloat_Check( pyobj ) ) return 2;
+        return PyInt_Check( pyobj ) || PyLong_Check( pyobj ) ? 1 : 0;
     }
     /// Make copy through copy constructor.
     DoubleQArgConstructor* Clone() const {
         return new DoubleQArgConstructor( *this );
     }
-private:
-    /// Storage for value read from Python.
-    mutable double d_;
 };
-/// QArgConstructor implementation for @c QString type.
+/// QArgConstructor implementation for @c float type.
 class FloatQArgConstructor : public QArgConstructor {
 public:
-    /// @brief create a @c float value from a PyObject then create 
-    /// QGenericArgument referencing the data member.
+    /// @brief create a @c float value from a PyObject into per-call storage.
     /// @param pyobj pointer to PyObject
-    /// @return QGenericArgument instance whose @c data field points
-    ///         to a private data member of this class' instance
-    QGenericArgument Create( PyObject* pyobj ) const {
-        f_ = float( PyFloat_AsDouble( pyobj ) );
-        return Q_ARG( float, f_ );
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const {
+        const double d = PyFloat_AsDouble( pyobj );
+        if( d == -1.0 && PyErr_Occurred() ) return 0;
+        return new ( storage ) float( d );
+    }
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( float ); }
+    /// Accept Python floats and integers.
+    int Check( PyObject* pyobj ) const {
+        if( PyFloat_Check( pyobj ) ) return 2;
+        return PyInt_Check( pyobj ) || PyLong_Check( pyobj ) ? 1 : 0;
     }
     /// Make copy through copy constructor.
     FloatQArgConstructor* Clone() const {
         return new FloatQArgConstructor( *this );
     }
-private:
-    /// Storage for value read from Python.
-    mutable float f_;
 };
-/// QArgConstructor implementation for @c integer type.
+/// QArgConstructor implementation for @c void* type.
 class VoidStarQArgConstructor : public QArgConstructor {
 public:
-    /// @brief create an @c integer value from a PyObject then create 
-    /// QGenericArgument referencing the data member.
+    /// @brief create a @c void* value from a PyObject into per-call storage.
     /// @param pyobj pointer to PyObject
-    /// @return QGenericArgument instance whose @c data field points
-    ///         to a private data member of this class' instance
-    QGenericArgument Create( PyObject* pyobj ) const {
-        i_ = PyLong_AsVoidPtr( pyobj );
-        return Q_ARG( void*, i_ );
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const {
+        void* p = PyLong_AsVoidPtr( pyobj );
+        if( !p && PyErr_Occurred() ) return 0;
+        return new ( storage ) void*( p );
+    }
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( void* ); }
+    /// Accept Python integers.
+    int Check( PyObject* pyobj ) const {
+        return PyInt_Check( pyobj ) || PyLong_Check( pyobj ) ? 2 : 0;
     }
     /// Make copy through copy constructor.
     VoidStarQArgConstructor* Clone() const {
         return new VoidStarQArgConstructor( *this );
     }
-private:
-    /// Storage for value read from Python.
-    mutable void* i_;
 };
-/// QArgConstructor implementation for @c integer type.
+/// QArgConstructor implementation for @c QObject* type.
 class ObjectStarQArgConstructor : public QArgConstructor {
 public:
-    /// @brief create an @c integer value from a PyObject then create 
-    /// QGenericArgument referencing the data member.
+    /// @brief create a @c QObject* value from a PyObject into per-call storage.
     /// @param pyobj pointer to PyObject
-    /// @return QGenericArgument instance whose @c data field points
-    ///         to a private data member of this class' instance
-    QGenericArgument Create( PyObject* pyobj ) const;
-
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const;
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( QObject* ); }
+    /// Accept QObject wrappers and @c None, converted to NULL.
+    int Check( PyObject* pyobj ) const;
     /// Make copy through copy constructor.
     ObjectStarQArgConstructor* Clone() const {
         return new ObjectStarQArgConstructor( *this );
     }
+};
+/// @brief QArgConstructor implementation for pointers to QObject-derived
+/// types, registered when a type is added to the context or the first time
+/// a method or property referencing the pointer type is wrapped.
+///
+/// The pointed type is identified by class name until a wrapper of the type or
+/// of a derived type is checked; its meta object is then stored and compared
+/// with the meta object hierarchy of the wrappers.
+class TypedObjectStarQArgConstructor : public QArgConstructor {
+public:
+    /// Constructor.
+    /// @param className class name of the pointed type
+    TypedObjectStarQArgConstructor( const QByteArray& className )
+        : className_( className ), mo_( 0 ) {}
+    /// @brief create a pointer value from a PyObject into per-call storage.
+    /// @param pyobj pointer to PyObject
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const;
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( QObject* ); }
+    /// Accept wrappers of objects of the pointed type or derived types and
+    /// @c None, converted to NULL.
+    int Check( PyObject* pyobj ) const;
+    /// Make copy through copy constructor.
+    TypedObjectStarQArgConstructor* Clone() const {
+        return new TypedObjectStarQArgConstructor( *this );
+    }
+private:
+    /// Return @c true if the type of the wrapper is the pointed type or is
+    /// derived from it.
+    bool Derived( PyObject* pyobj ) const;
 private:
-    /// Storage for value read from Python.
-    mutable QObject* obj_;
+    QByteArray className_;
+    /// Meta object of the pointed type, NULL until resolved
+    mutable const QMetaObject* mo_;
+};
+
+/// @brief QArgConstructor implementation for @c QByteArray type, accepting any
+/// object supporting the buffer protocol.
+///
+/// The QByteArray shares the data of @c qpy.ByteArray objects without copy;
+/// the content of other buffers is copied, since the invoked method could
+/// retain the QByteArray beyond the lifetime of the Python buffer.
+class ByteArrayQArgConstructor : public QArgConstructor {
+public:
+    /// @brief create a @c QByteArray from the PyObject buffer into
+    /// per-call storage.
+    /// @param pyobj pointer to PyObject
+    /// @param storage memory area of StorageSize() bytes
+    /// @return address of created value or NULL in case of conversion error
+    void* Construct( PyObject* pyobj, void* storage ) const;
+    /// Size of storage.
+    size_t StorageSize() const { return sizeof( QByteArray ); }
+    /// Destroy QByteArray.
+    void Destroy( void* p ) const {
+        reinterpret_cast< QByteArray* >( p )->~QByteArray();
+    }
+    /// Accept objects supporting the buffer protocol.
+    int Check( PyObject* pyobj ) const;
+    /// Create new instance.
+    ByteArrayQArgConstructor* Clone() const {
+        return new ByteArrayQArgConstructor;
+    }
 };
 
 /// PyArgConstructor implementation for @c integer type
 class IntPyArgConstructor : public PyArgConstructor {
 public:
-    IntPyArgConstructor() {
-        SetArg( i_ );
-    }
-    IntPyArgConstructor( const IntPyArgConstructor& other ) : i_( other.i_ ) {
-        SetArg( i_ );
-    }
     PyObject* Create( void* p ) const {
         int i = *reinterpret_cast< int* >( p );
         return PyInt_FromLong( i );
     }
-    PyObject* Create() const {
-        return PyInt_FromLong( i_ );
-    }
+    size_t StorageSize() const { return sizeof( int ); }
+    void* Construct( void* storage ) const { return new ( storage ) int( 0 ); }
     IntPyArgConstructor* Clone() const {
         return new IntPyArgConstructor( *this );
     }
     bool IsQObjectPtr() const { return false; }
     QMetaType::Type Type() const { return QMetaType::Int; }
-private:
-    int i_; 
 };
 /// PyArgConstructor implementation for @c QString type
 class StringPyArgConstructor : public PyArgConstructor {
 public:
-    StringPyArgConstructor() {
-        SetArg( s_ );
-    }
-    StringPyArgConstructor( const StringPyArgConstructor& other ) : s_( other.s_ ) {
-        SetArg( s_ );
-    }
     PyObject* Create( void* p ) const {
-        QString s = *reinterpret_cast< QString* >( p );
-        return PyString_FromString( s.toAscii().constData() );
+        return StringToPy( *reinterpret_cast< QString* >( p ) );
     }
-    PyObject* Create() const {
-        return PyString_FromString( s_.toAscii().constData() );
+    size_t StorageSize() const { return sizeof( QString ); }
+    void* Construct( void* storage ) const { return new ( storage ) QString; }
+    void Destroy( void* p ) const {
+        reinterpret_cast< QString* >( p )->~QString();
     }
     StringPyArgConstructor* Clone() const {
         return new StringPyArgConstructor( *this );
     }
     bool IsQObjectPtr() const { return false; }
     QMetaType::Type Type() const { return QMetaType::QString; }
-private:
-    QString s_; 
 };
 /// PyArgConstructor implementation for @c double type
 class DoublePyArgConstructor : public PyArgConstructor {
 public:
-    DoublePyArgConstructor() {
-        SetArg( d_ );
-    }
-    DoublePyArgConstructor( const DoublePyArgConstructor& other ) : d_( other.d_ ) {
-        SetArg( d_ );
-    }
     PyObject* Create( void* p ) const {
         double d = *reinterpret_cast< double* >( p );
         return PyFloat_FromDouble( d );
     }
-    PyObject* Create() const {
-        return PyFloat_FromDouble( d_ );
-    }
+    size_t StorageSize() const { return sizeof( double ); }
+    void* Construct( void* storage ) const { return new ( storage ) double( 0 ); }
     DoublePyArgConstructor* Clone() const {
         return new DoublePyArgConstructor( *this );
     }
     bool IsQObjectPtr() const { return false; }
     QMetaType::Type Type() const { return QMetaType::Double; }
-private:
-    double d_; 
 };
 /// PyArgConstructor implementation for @c float type
 class FloatPyArgConstructor : public PyArgConstructor {
 public:
-    FloatPyArgConstructor() {
-        SetArg( f_ );
-    }
-    FloatPyArgConstructor( const FloatPyArgConstructor& other ) : f_( other.f_ ) {
-        SetArg( f_ );
-    }
     PyObject* Create( void* p ) const {
         float f = *reinterpret_cast< float* >( p );
         return PyFloat_FromDouble( f );
     }
-    PyObject* Create() const {
-        return PyFloat_FromDouble( f_ );
-    }
+    size_t StorageSize() const { return sizeof( float ); }
+    void* Construct( void* storage ) const { return new ( storage ) float( 0 ); }
     FloatPyArgConstructor* Clone() const {
         return new FloatPyArgConstructor( *this );
     }
     bool IsQObjectPtr() const { return false; }
     QMetaType::Type Type() const { return QMetaType::Float; }
-private:
-    float f_; 
 };
 
 /// PyArgConstructor implementation for @c void type
@@ -270,6 +327,7 @@ public:
         Py_RETURN_NONE;
     } 
     PyObject* Create( void* ) const { return 0; }
+    void* Construct( void* ) const { return 0; }
     VoidPyArgConstructor* Clone() const {
         return new VoidPyArgConstructor( *this );
     }
@@ -280,25 +338,51 @@ public:
 /// PyArgConstructor implementation for @c QObject* type
 class ObjectStarPyArgConstructor : public PyArgConstructor {
 public:
-    ObjectStarPyArgConstructor() {
-        SetArg( obj_ );   
-    }
-    ObjectStarPyArgConstructor( const ObjectStarPyArgConstructor& other ) : obj_( other.obj_ ) {
-        SetArg( obj_ );   
-    }
     PyObject* Create() const {
         Py_RETURN_NONE;
     }
     PyObject* Create( void* ) const {
         Py_RETURN_NONE;
     }
+    size_t StorageSize() const { return sizeof( QObject* ); }
+    void* Construct( void* storage ) const { return new ( storage ) QObject*( 0 ); }
     ObjectStarPyArgConstructor* Clone() const {
         return new ObjectStarPyArgConstructor( *this );
     }
     bool IsQObjectPtr() const { return true; }
     QMetaType::Type Type() const { return QMetaType::QObjectStar; }
+};
+/// @brief PyArgConstructor implementation for pointers to QObject-derived
+/// types; returned objects are wrapped with the Python type matching their
+/// dynamic type.
+///
+/// Pointers are known to reference QObjects only after the pointed type or a
+/// type derived from it has been added to the context: until then non-NULL
+/// values cannot be converted.
+class TypedObjectStarPyArgConstructor : public ObjectStarPyArgConstructor {
+public:
+    /// Constructor.
+    /// @param type meta type id of the pointer type
+    /// @param className class name of the pointed type
+    /// @param ctx context where the pointed type is added
+    TypedObjectStarPyArgConstructor( int type, const QByteArray& className,
+                                     const PyContext* ctx )
+        : type_( type ), className_( className ), ctx_( ctx ), qobject_( false ) {}
+    using ObjectStarPyArgConstructor::Create;
+    /// Invoked only when the pointed type is not known to be a QObject.
+    PyObject* Create( void* p ) const;
+    TypedObjectStarPyArgConstructor* Clone() const {
+        return new TypedObjectStarPyArgConstructor( *this );
+    }
+    /// Look up the pointed type in the context until it has been added.
+    bool IsQObjectPtr() const;
+    QMetaType::Type Type() const { return QMetaType::Type( type_ ); }
 private:
-    QObject* obj_;
+    int type_;
+    QByteArray className_;
+    const PyContext* ctx_;
+    /// @c true once the pointed type is known to be a QObject
+    mutable bool qobject_;
 };
 
 }
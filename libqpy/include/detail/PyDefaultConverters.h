@@ -0,0 +1,524 @@
+#pragma once
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief Converter classes for the default types registered through
+/// PyContext::RegisterConverter.
+///
+/// Values are converted directly between the Qt and Python representations:
+/// - @c bool, @c uint, @c qlonglong, @c qulonglong: Python @c bool, @c int
+///   and @c long
+/// - @c QChar: one character @c unicode
+/// - @c QByteArray: @c qpy.ByteArray, exporting the buffer protocol
+/// - @c QStringList: @c list of strings, see StringToPy
+/// - @c QDate, @c QTime, @c QDateTime: @c datetime.date, @c datetime.time,
+///   @c datetime.datetime
+/// - @c QUrl: encoded url as @c str
+/// - @c QPoint(F), @c QSize(F): @c (x, y) and @c (width, height) tuples
+/// - @c QRect(F): @c (x, y, width, height) tuples
+/// - @c QVector and @c QList of @c short, @c int, @c qint64, @c float and
+///   @c double: @c array.array; any object supporting the buffer protocol
+///   and any sequence of numbers are accepted
+/// - @c QVector<float> and @c QVector<double>: @c qpy.FloatVector and
+///   @c qpy.DoubleVector, exporting the buffer protocol and
+///   @c __array_interface__
+
+#include <Python.h>
+#include <cstring>
+#include <climits>
+#include <cfloat>
+#include <limits>
+#include <QChar>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include <QUrl>
+#include <QPoint>
+#include <QPointF>
+#include <QSize>
+#include <QSizeF>
+#include <QRect>
+#include <QRectF>
+#include <QVector>
+#include <QList>
+
+namespace qpy {
+
+/// @c bool <--> Python @c bool
+struct BoolConverter {
+    PyObject* ToPy( const bool& b ) const { return PyBool_FromLong( b ); }
+    bool FromPy( PyObject* pyobj, bool& b ) const {
+        const int r = PyObject_IsTrue( pyobj );
+        b = r == 1;
+        return r >= 0;
+    }
+    int Check( PyObject* pyobj ) const { return PyBool_Check( pyobj ) ? 2 : 1; }
+};
+/// @c uint <--> Python @c int
+struct UIntConverter {
+    PyObject* ToPy( const uint& i ) const { return PyLong_FromUnsignedLong( i ); }
+    bool FromPy( PyObject* pyobj, uint& i ) const {
+        const unsigned long l = PyLong_AsUnsignedLong( pyobj );
+        if( l == ( unsigned long )-1 && PyErr_Occurred() ) return false;
+        // unsigned long is wider than uint on LP64 platforms
+        if( l > UINT_MAX ) {
+            PyErr_SetString( PyExc_OverflowError, "Value too large for uint" );
+            return false;
+        }
+        i = uint( l );
+        return true;
+    }
+    int Check( PyObject* pyobj ) const {
+        return PyInt_Check( pyobj ) || PyLong_Check( pyobj ) ? 1 : 0;
+    }
+};
+/// @c qlonglong <--> Python @c long
+struct LongLongConverter {
+    PyObject* ToPy( const qlonglong& i ) const { return PyLong_FromLongLong( i ); }
+    bool FromPy( PyObject* pyobj, qlonglong& i ) const {
+        i = PyLong_AsLongLong( pyobj );
+        return !( i == -1 && PyErr_Occurred() );
+    }
+    int Check( PyObject* pyobj ) const {
+        if( PyLong_Check( pyobj ) ) return 2;
+        return PyInt_Check( pyobj ) ? 1 : 0;
+    }
+};
+/// @c qulonglong <--> Python @c long
+struct ULongLongConverter {
+    PyObject* ToPy( const qulonglong& i ) const { return PyLong_FromUnsignedLongLong( i ); }
+    bool FromPy( PyObject* pyobj, qulonglong& i ) const;
+    int Check( PyObject* pyobj ) const {
+        return PyInt_Check( pyobj ) || PyLong_Check( pyobj ) ? 1 : 0;
+    }
+};
+/// @c QChar <--> one character Python @c unicode or @c str
+struct CharConverter {
+    PyObject* ToPy( const QChar& c ) const {
+        const Py_UNICODE u = c.unicode();
+        return PyUnicode_FromUnicode( &u, 1 );
+    }
+    bool FromPy( PyObject* pyobj, QChar& c ) const;
+    int Check( PyObject* pyobj ) const {
+        return PyUnicode_Check( pyobj ) || PyString_Check( pyobj ) ? 1 : 0;
+    }
+};
+/// @c QByteArray <--> Python buffer.
+///
+/// Qt values are returned as @c qpy.ByteArray objects which share the data of
+/// the QByteArray and export it through the buffer protocol; any object
+/// supporting the buffer protocol is converted to a QByteArray by copying
+/// its content. Method arguments are converted without copy by
+/// ByteArrayQArgConstructor.
+struct ByteArrayConverter {
+    PyObject* ToPy( const QByteArray& b ) const;
+    bool FromPy( PyObject* pyobj, QByteArray& b ) const;
+    int Check( PyObject* pyobj ) const {
+        if( !PyObject_CheckBuffer( pyobj ) ) return 0;
+        // str is also accepted by QString
+        return PyString_Check( pyobj ) ? 1 : 2;
+    }
+    /// Return pointer to QByteArray if object is a @c qpy.ByteArray, NULL otherwise.
+    static const QByteArray* Get( PyObject* pyobj );
+};
+/// @c QStringList <--> Python @c list of strings; any sequence is accepted
+struct StringListConverter {
+    PyObject* ToPy( const QStringList& l ) const;
+    bool FromPy( PyObject* pyobj, QStringList& l ) const;
+    int Check( PyObject* pyobj ) const {
+        return PyList_Check( pyobj ) || PyTuple_Check( pyobj ) ? 1 : 0;
+    }
+};
+/// @c QDate <--> Python @c datetime.date
+struct DateConverter {
+    PyObject* ToPy( const QDate& d ) const;
+    bool FromPy( PyObject* pyobj, QDate& d ) const;
+    int Check( PyObject* pyobj ) const;
+};
+/// @c QTime <--> Python @c datetime.time
+struct TimeConverter {
+    PyObject* ToPy( const QTime& t ) const;
+    bool FromPy( PyObject* pyobj, QTime& t ) const;
+    int Check( PyObject* pyobj ) const;
+};
+/// @c QDateTime <--> Python @c datetime.datetime
+struct DateTimeConverter {
+    PyObject* ToPy( const QDateTime& dt ) const;
+    bool FromPy( PyObject* pyobj, QDateTime& dt ) const;
+    int Check( PyObject* pyobj ) const;
+};
+/// @c QUrl <--> Python @c str
+struct UrlConverter {
+    PyObject* ToPy( const QUrl& u ) const {
+        const QByteArray e = u.toEncoded();
+        return PyString_FromStringAndSize( e.constData(), e.size() );
+    }
+    bool FromPy( PyObject* pyobj, QUrl& u ) const;
+    int Check( PyObject* pyobj ) const {
+        return PyString_Check( pyobj ) || PyUnicode_Check( pyobj ) ? 1 : 0;
+    }
+};
+/// Base class of converters from and to tuples
+struct TupleConverter {
+    int Check( PyObject* pyobj ) const { return PyTuple_Check( pyobj ) ? 1 : 0; }
+protected:
+    /// Parse tuple according to format, raise @c TypeError
+    /// if not a tuple.
+    static bool Parse( PyObject* pyobj, const char* format, void* a, void* b,
+                       void* c = 0, void* d = 0 );
+};
+/// @c QPoint <--> Python @c (x, y)
+struct PointConverter : TupleConverter {
+    PyObject* ToPy( const QPoint& p ) const { return Py_BuildValue( "(ii)", p.x(), p.y() ); }
+    bool FromPy( PyObject* pyobj, QPoint& p ) const {
+        int x, y;
+        if( !Parse( pyobj, "ii", &x, &y ) ) return false;
+        p = QPoint( x, y );
+        return true;
+    }
+};
+/// @c QPointF <--> Python @c (x, y)
+struct PointFConverter : TupleConverter {
+    PyObject* ToPy( const QPointF& p ) const { return Py_BuildValue( "(dd)", p.x(), p.y() ); }
+    bool FromPy( PyObject* pyobj, QPointF& p ) const {
+        double x, y;
+        if( !Parse( pyobj, "dd", &x, &y ) ) return false;
+        p = QPointF( x, y );
+        return true;
+    }
+};
+/// @c QSize <--> Python @c (width, height)
+struct SizeConverter : TupleConverter {
+    PyObject* ToPy( const QSize& s ) const { 
+        return Py_BuildValue( "(ii)", s.width(), s.height() );
+    }
+    bool FromPy( PyObject* pyobj, QSize& s ) const {
+        int w, h;
+        if( !Parse( pyobj, "ii", &w, &h ) ) return false;
+        s = QSize( w, h );
+        return true;
+    }
+};
+/// @c QSizeF <--> Python @c (width, height)
+struct SizeFConverter : TupleConverter {
+    PyObject* ToPy( const QSizeF& s ) const {
+        return Py_BuildValue( "(dd)", s.width(), s.height() );
+    }
+    bool FromPy( PyObject* pyobj, QSizeF& s ) const {
+        double w, h;
+        if( !Parse( pyobj, "dd", &w, &h ) ) return false;
+        s = QSizeF( w, h );
+        return true;
+    }
+};
+/// @c QRect <--> Python @c (x, y, width, height)
+struct RectConverter : TupleConverter {
+    PyObject* ToPy( const QRect& r ) const {
+        return Py_BuildValue( "(iiii)", r.x(), r.y(), r.width(), r.height() );
+    }
+    bool FromPy( PyObject* pyobj, QRect& r ) const {
+        int x, y, w, h;
+        if( !Parse( pyobj, "iiii", &x, &y, &w, &h ) ) return false;
+        r = QRect( x, y, w, h );
+        return true;
+    }
+};
+/// @c QRectF <--> Python @c (x, y, width, height)
+struct RectFConverter : TupleConverter {
+    PyObject* ToPy( const QRectF& r ) const {
+        return Py_BuildValue( "(dddd)", r.x(), r.y(), r.width(), r.height() );
+    }
+    bool FromPy( PyObject* pyobj, QRectF& r ) const {
+        double x, y, w, h;
+        if( !Parse( pyobj, "dddd", &x, &y, &w, &h ) ) return false;
+        r = QRectF( x, y, w, h );
+        return true;
+    }
+};
+
+/// @brief Element type of numeric containers: array type code and conversion
+/// of single elements.
+template < typename T > struct NumericElement;
+template <> struct NumericElement< short > {
+    static char TypeCode() { return 'h'; }
+    static PyObject* ToPy( short v ) { return PyInt_FromLong( v ); }
+    static bool FromPy( PyObject* pyobj, short& v ) {
+        const long l = PyInt_AsLong( pyobj );
+        if( l == -1 && PyErr_Occurred() ) return false;
+        if( l < SHRT_MIN || l > SHRT_MAX ) {
+            PyErr_SetString( PyExc_OverflowError, "Value out of range for short" );
+            return false;
+        }
+        v = short( l );
+        return true;
+    }
+};
+template <> struct NumericElement< int > {
+    static char TypeCode() { return 'i'; }
+    static PyObject* ToPy( int v ) { return PyInt_FromLong( v ); }
+    static bool FromPy( PyObject* pyobj, int& v ) {
+        const long l = PyInt_AsLong( pyobj );
+        if( l == -1 && PyErr_Occurred() ) return false;
+        if( l < INT_MIN || l > INT_MAX ) {
+            PyErr_SetString( PyExc_OverflowError, "Value out of range for int" );
+            return false;
+        }
+        v = int( l );
+        return true;
+    }
+};
+template <> struct NumericElement< qint64 > {
+    /// Python 2 arrays do not support @c long @c long: returned as list if
+    /// @c long is not a 64 bit type
+    static char TypeCode() { return sizeof( long ) == sizeof( qint64 ) ? 'l' : 0; }
+    static PyObject* ToPy( qint64 v ) { return PyLong_FromLongLong( v ); }
+    static bool FromPy( PyObject* pyobj, qint64& v ) {
+        v = PyLong_AsLongLong( pyobj );
+        return !( v == -1 && PyErr_Occurred() );
+    }
+};
+template <> struct NumericElement< float > {
+    static char TypeCode() { return 'f'; }
+    static PyObject* ToPy( float v ) { return PyFloat_FromDouble( v ); }
+    static bool FromPy( PyObject* pyobj, float& v ) {
+        const double d = PyFloat_AsDouble( pyobj );
+        if( d == -1.0 && PyErr_Occurred() ) return false;
+        // infinity is preserved
+        if( ( d > FLT_MAX || d < -FLT_MAX )
+            && d != std::numeric_limits< double >::infinity()
+            && d != -std::numeric_limits< double >::infinity() ) {
+            PyErr_SetString( PyExc_OverflowError, "Value out of range for float" );
+            return false;
+        }
+        v = float( d );
+        return true;
+    }
+};
+template <> struct NumericElement< double > {
+    static char TypeCode() { return 'd'; }
+    static PyObject* ToPy( double v ) { return PyFloat_FromDouble( v ); }
+    static bool FromPy( PyObject* pyobj, double& v ) {
+        v = PyFloat_AsDouble( pyobj );
+        return !( v == -1.0 && PyErr_Occurred() );
+    }
+};
+
+/// @c true if all values of type @c S are represented exactly by type @c T:
+/// integers are converted to wider integers and floating point values to
+/// wider floating point values only.
+template < typename S, typename T > struct LosslessConversion {
+    enum { value = std::numeric_limits< S >::is_integer == std::numeric_limits< T >::is_integer
+                   && ( !std::numeric_limits< S >::is_signed || std::numeric_limits< T >::is_signed )
+                   && std::numeric_limits< S >::digits <= std::numeric_limits< T >::digits };
+};
+/// Copy numeric values converting from type @c S to @c T; values of the same
+/// type are copied with @c memcpy, other loops are vectorized by the compiler.
+template < typename S, typename T > struct NumericCopy {
+    static void Copy( const void* src, T* dest, Py_ssize_t n ) {
+        const S* s = static_cast< const S* >( src );
+        for( Py_ssize_t i = 0; i != n; ++i ) dest[ i ] = T( s[ i ] );
+    }
+};
+template < typename T > struct NumericCopy< T, T > {
+    static void Copy( const void* src, T* dest, Py_ssize_t n ) {
+        if( n ) std::memcpy( dest, src, n * sizeof( T ) );
+    }
+};
+/// Copy buffer elements of type @c S, if the buffer item size matches and
+/// the conversion is lossless.
+template < typename S, typename T >
+bool CopyNumeric( Py_ssize_t itemSize, const void* src, T* dest, Py_ssize_t n ) {
+    if( !LosslessConversion< S, T >::value || itemSize != Py_ssize_t( sizeof( S ) ) ) return false;
+    NumericCopy< S, T >::Copy( src, dest, n );
+    return true;
+}
+/// Copy @c n buffer elements with @c struct module format character @c format.
+/// @return @c false if format not supported or not convertible without loss
+template < typename T >
+bool CopyFromBuffer( char format, Py_ssize_t itemSize, const void* src, T* dest, Py_ssize_t n ) {
+    switch( format ) {
+    case 'b': return CopyNumeric< signed char >( itemSize, src, dest, n );
+    case 'B': return CopyNumeric< unsigned char >( itemSize, src, dest, n );
+    case 'h': return CopyNumeric< short >( itemSize, src, dest, n );
+    case 'H': return CopyNumeric< unsigned short >( itemSize, src, dest, n );
+    case 'i': return CopyNumeric< int >( itemSize, src, dest, n );
+    case 'I': return CopyNumeric< unsigned int >( itemSize, src, dest, n );
+    case 'l': return CopyNumeric< long >( itemSize, src, dest, n );
+    case 'L': return CopyNumeric< unsigned long >( itemSize, src, dest, n );
+    case 'q': return CopyNumeric< qint64 >( itemSize, src, dest, n );
+    case 'Q': return CopyNumeric< quint64 >( itemSize, src, dest, n );
+    case 'f': return CopyNumeric< float >( itemSize, src, dest, n );
+    case 'd': return CopyNumeric< double >( itemSize, src, dest, n );
+    default: return false;
+    }
+}
+
+/// @brief Contiguous buffer of numeric values.
+///
+/// Data are accessed through the buffer protocol or, for @c array.array
+/// objects which in Python 2 only support the old buffer interface, through
+/// the old buffer interface and the array type code.
+class NumericBuffer {
+public:
+    NumericBuffer() : format( 0 ), itemSize( 0 ), data( 0 ), size( 0 ), hasView_( false ) {}
+    ~NumericBuffer() { if( hasView_ ) PyBuffer_Release( &view_ ); }
+    /// Access object data.
+    /// @return 1 if data available, 0 if object is not a contiguous numeric
+    ///         buffer, -1 in case of error, with Python exception set
+    int Get( PyObject* pyobj );
+    /// @c struct module format character
+    char format;
+    Py_ssize_t itemSize;
+    const void* data;
+    /// number of elements
+    Py_ssize_t size;
+private:
+    NumericBuffer( const NumericBuffer& );
+    NumericBuffer& operator=( const NumericBuffer& );
+    Py_buffer view_;
+    bool hasView_;
+};
+
+/// Create @c array.array from numeric values.
+PyObject* NewNumericArray( char typeCode, const void* data, Py_ssize_t size, Py_ssize_t itemSize );
+
+/// Create zero initialized @c array.array of @c size elements; the address of
+/// the array data is returned in @c data.
+PyObject* NewNumericArray( char typeCode, Py_ssize_t size, void** data );
+
+/// Copy container values to contiguous memory.
+template < typename T >
+void CopyNumericData( const QVector< T >& v, T* dest ) {
+    if( !v.isEmpty() ) std::memcpy( dest, v.constData(), v.size() * sizeof( T ) );
+}
+template < typename T >
+void CopyNumericData( const QList< T >& l, T* dest ) {
+    for( typename QList< T >::const_iterator i = l.begin(); i != l.end(); ++i ) *dest++ = *i;
+}
+/// Assign values to container; QVector shares data.
+template < typename T >
+void AssignNumeric( QVector< T >& v, const QVector< T >& values ) { v = values; }
+template < typename T >
+void AssignNumeric( QList< T >& l, const QVector< T >& values ) {
+    l.clear();
+    l.reserve( values.size() );
+    for( typename QVector< T >::const_iterator i = values.begin(); i != values.end(); ++i ) {
+        l.push_back( *i );
+    }
+}
+
+/// @c QVector<T> or @c QList<T> <--> Python @c array.array
+template < typename ContainerT, typename T >
+struct NumericContainerConverter {
+    PyObject* ToPy( const ContainerT& c ) const {
+        const char typeCode = NumericElement< T >::TypeCode();
+        if( typeCode ) {
+            // values copied directly into the array memory
+            void* data = 0;
+            PyObject* a = NewNumericArray( typeCode, c.size(), &data );
+            if( a ) CopyNumericData( c, static_cast< T* >( data ) );
+            return a;
+        }
+        PyObject* list = PyList_New( c.size() );
+        for( int i = 0; list && i != c.size(); ++i ) {
+            PyObject* item = NumericElement< T >::ToPy( c.at( i ) );
+            if( !item ) {
+                Py_CLEAR( list );
+                break;
+            }
+            PyList_SET_ITEM( list, i, item );
+        }
+        return list;
+    }
+    bool FromPy( PyObject* pyobj, ContainerT& c ) const {
+        QVector< T > values;
+        NumericBuffer b;
+        const int r = b.Get( pyobj );
+        if( r < 0 ) return false;
+        if( r > 0 ) {
+            values.resize( int( b.size ) );
+            if( !CopyFromBuffer( b.format, b.itemSize, b.data, values.data(), b.size ) ) {
+                PyErr_SetString( PyExc_TypeError, "Buffer format not supported or not "
+                                                  "convertible without loss" );
+                return false;
+            }
+        } else {
+            PyObject* seq = PySequence_Fast( pyobj, "Sequence or buffer of numbers required" );
+            if( !seq ) return false;
+            const Py_ssize_t size = PySequence_Fast_GET_SIZE( seq );
+            values.resize( int( size ) );
+            for( Py_ssize_t i = 0; i != size; ++i ) {
+                if( !NumericElement< T >::FromPy( PySequence_Fast_GET_ITEM( seq, i ), values[ int( i ) ] ) ) {
+                    Py_DECREF( seq );
+                    return false;
+                }
+            }
+            Py_DECREF( seq );
+        }
+        AssignNumeric( c, values );
+        return true;
+    }
+    int Check( PyObject* pyobj ) const {
+        if( PyString_Check( pyobj ) || PyUnicode_Check( pyobj ) ) return 0;
+        if( PyObject_CheckBuffer( pyobj ) ) return 2;
+        return PySequence_Check( pyobj ) ? 1 : 0;
+    }
+};
+
+/// @brief Create @c qpy.FloatVector or @c qpy.DoubleVector sharing the vector
+/// data.
+///
+/// The data are exported read-only through the buffer protocol and
+/// @c __array_interface__, e.g. for zero-copy access from numpy, and remain
+/// valid as long as the Python object or any object referencing it, such as
+/// a numpy array, is alive.
+PyObject* NumericVectorToPy( const QVector< float >& v );
+PyObject* NumericVectorToPy( const QVector< double >& v );
+/// Return vector wrapped by @c qpy.FloatVector, NULL if other type.
+const QVector< float >* NumericVectorGet( PyObject* pyobj, float* );
+/// Return vector wrapped by @c qpy.DoubleVector, NULL if other type.
+const QVector< double >* NumericVectorGet( PyObject* pyobj, double* );
+
+/// @c QVector<float> and @c QVector<double> <--> @c qpy.FloatVector and
+/// @c qpy.DoubleVector; arguments accept the same objects as
+/// NumericContainerConverter and share the data of vectors returned by
+/// NumericVectorToPy.
+template < typename T >
+struct NumericVectorConverter : NumericContainerConverter< QVector< T >, T > {
+    PyObject* ToPy( const QVector< T >& v ) const { return NumericVectorToPy( v ); }
+    bool FromPy( PyObject* pyobj, QVector< T >& v ) const {
+        if( const QVector< T >* s = NumericVectorGet( pyobj, static_cast< T* >( 0 ) ) ) {
+            v = *s;
+            return true;
+        }
+        return NumericContainerConverter< QVector< T >, T >::FromPy( pyobj, v );
+    }
+};
+
+}
@@ -31,6 +31,7 @@
 #include <QString>
 #include "../PyQVariantToPyObject.h"
 #include "../PyObjectToQVariant.h"
+#include "PyStringConversion.h"
 
 namespace qpy {
 
@@ -52,8 +53,11 @@ struct DoubleQVariantToPyObject : QVariantToPyObject {
 struct StringQVariantToPyObject : QVariantToPyObject {
     StringQVariantToPyObject( bool f ) : QVariantToPyObject( f ) {}
     PyObject* Create( const QVariant& v ) const {
-        return PyString_FromString( qPrintable( v.toString() ) );
-    } 
+        if( v.type() == QVariant::String ) {
+            return StringToPy( *reinterpret_cast< const QString* >( v.constData() ) );
+        }
+        return StringToPy( v.toString() );
+    }
 };
 
 /// @brief Python int to QVariant conversion
@@ -74,7 +78,9 @@ struct DoublePyObjectToQVariant : PyObjectToQVariant {
 struct StringPyObjectToQVariant : PyObjectToQVariant {
     StringPyObjectToQVariant( bool f ) : PyObjectToQVariant( f ) {}
     QVariant Create( PyObject* obj ) const {
-        return QVariant( PyString_AsString( obj ) );
+        QString s;
+        if( !PyToString( obj, s ) ) return QVariant();
+        return QVariant( s );
     }
 };
 
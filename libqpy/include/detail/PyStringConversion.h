@@ -0,0 +1,63 @@
+#pragma once
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief Conversion functions between QString and Python strings.
+///
+/// QString data is UTF-16 and is converted directly to and from the internal
+/// representation of Python @c unicode objects, without intermediate byte
+/// arrays: ASCII text is returned as @c str, any other text as @c unicode.
+
+#include <Python.h>
+#include <QString>
+
+namespace qpy {
+
+/// @brief Create Python string from QString.
+///
+/// If the string cache is enabled short strings are looked up in the cache
+/// and the cached Python object is returned.
+/// @return new reference or NULL in case of error
+PyObject* StringToPy( const QString& s );
+/// @brief Convert Python @c unicode or @c str to QString; @c str is decoded
+/// as UTF-8.
+/// @return @c false and set Python error if object is not a string
+bool PyToString( PyObject* pyobj, QString& s );
+/// @brief Set number of entries of the cache of Python strings created from
+/// short QStrings.
+///
+/// Strings up to STRING_CACHE_MAX_LENGTH characters are stored into a direct
+/// mapped table indexed by the string hash value; a new string replaces the
+/// one stored in the same slot. The cache is global to the process. Size
+/// zero (default) disables the cache and releases the cached strings, and
+/// must be set before the interpreter is finalized if the cache was enabled;
+/// PyContext does it when the last context is destroyed.
+void SetStringCacheSize( int entries );
+/// Return number of entries of the string cache.
+int StringCacheSize();
+/// Maximum length of strings stored into the string cache.
+const int STRING_CACHE_MAX_LENGTH = 32;
+}
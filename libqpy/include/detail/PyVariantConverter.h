@@ -0,0 +1,93 @@
+#pragma once
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief Recursive converters for QVariantList, QVariantMap and QVariantHash.
+
+#include <Python.h>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QMetaType>
+
+namespace qpy {
+
+class PyContext;
+
+/// @brief Recursive conversion between QVariant containers and Python @c list
+/// and @c dict.
+///
+/// Containers are traversed through an explicit stack, so nesting depth is
+/// limited only by available memory; Python lists and dicts are created with
+/// the size of the Qt containers. Elements are converted through the QVariant
+/// converters registered in the PyContext instance, indexed by meta type id:
+/// - QVariant -> Python: the element's QVariant::userType selects the converter,
+///   invalid QVariants are converted to @c None
+/// - Python -> QVariant: @c None, @c bool, @c int, @c long, @c float, @c str,
+///   @c unicode, @c qpy.ByteArray and @c datetime objects select the
+///   converter of the corresponding Qt type; @c list and @c tuple are
+///   converted to QVariantList, @c dict with string keys to QVariantMap
+class VariantConverter {
+public:
+    /// Constructor.
+    VariantConverter( const PyContext* ctx = 0 ) : ctx_( ctx ) {}
+    /// Convert QVariant to PyObject.
+    /// @return new reference or NULL in case of error
+    PyObject* QVariantToPy( const QVariant& v ) const;
+    /// @brief Convert PyObject to QVariant.
+    /// @param type QMetaType::QVariantList, QMetaType::QVariantMap or
+    ///        QMetaType::QVariantHash to require a container of that type,
+    ///        QMetaType::QVariant for any value; nested dicts are always
+    ///        converted to QVariantMap
+    /// @return @c false and set Python error in case of error
+    bool PyToQVariant( PyObject* pyobj, QVariant& v,
+                       int type = QMetaType::QVariant ) const;
+    /// Return 2 if PyObject matches container type, 0 otherwise.
+    static int CheckContainer( PyObject* pyobj, int type );
+private:
+    PyObject* ElementToPy( const QVariant& v ) const;
+    bool PyToElement( PyObject* pyobj, QVariant& v ) const;
+private:
+    const PyContext* ctx_;
+};
+
+/// Converter for QVariantList, QVariantMap and QVariantHash, see
+/// PyContext::RegisterConverter.
+template < typename T >
+struct VariantContainerConverter : VariantConverter {
+    VariantContainerConverter( const PyContext* ctx = 0 ) : VariantConverter( ctx ) {}
+    PyObject* ToPy( const T& c ) const { return QVariantToPy( QVariant( c ) ); }
+    bool FromPy( PyObject* pyobj, T& c ) const {
+        QVariant v;
+        if( !PyToQVariant( pyobj, v, qMetaTypeId< T >() ) ) return false;
+        c = *reinterpret_cast< const T* >( v.constData() );
+        return true;
+    }
+    int Check( PyObject* pyobj ) const { 
+        return CheckContainer( pyobj, qMetaTypeId< T >() );
+    }
+};
+}
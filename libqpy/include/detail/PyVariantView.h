@@ -0,0 +1,59 @@
+#pragma once
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief Lazy Python views of QVariantList, QVariantMap and QVariantHash.
+///
+/// A view holds an implicitly shared copy of the Qt container and converts
+/// elements to Python on access: returning a view is O(1) regardless of the
+/// container size. Views are returned by the methods selected through
+/// PyMemberNameMapper::returnView.
+/// - @c qpy.VariantListView: @c len, indexing, iteration and @c in
+/// - @c qpy.VariantMapView, @c qpy.VariantHashView: @c len, indexing and
+///   @c in by string key, iteration over keys, @c keys() and @c get()
+/// Nested containers are returned as views.
+
+#include <Python.h>
+#include <QVariant>
+#include "PyVariantConverter.h"
+
+namespace qpy {
+
+/// @brief Create view of QVariantList, QVariantMap or QVariantHash; other
+/// values are converted through the VariantConverter.
+/// @return new reference or NULL in case of error
+PyObject* NewVariantView( const QVariant& v, const VariantConverter& c );
+
+/// Converter returning views of QVariant containers, see
+/// ConverterPyArgConstructor.
+template < typename T >
+struct VariantViewConverter {
+    VariantViewConverter( const VariantConverter& c = VariantConverter() ) : c_( c ) {}
+    PyObject* ToPy( const T& v ) const { return NewVariantView( QVariant( v ), c_ ); }
+private:
+    VariantConverter c_;
+};
+}
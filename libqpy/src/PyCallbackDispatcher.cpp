@@ -99,10 +99,16 @@ void PyCBackMethod::Invoke( void **arguments ) {
          i != paramTypes_.end(); ++i, ++arguments, ++t ) {
         PyObject* obj = 0;
         if( i->IsQObjectPtr() ) {
-           obj = pc_->AddObject( reinterpret_cast< QObject* >( *arguments ), pyModule_, pyModule_, 0 );
+           obj = pc_->AddObject( *reinterpret_cast< QObject** >( *arguments ), pyModule_, pyModule_, 0 );
         } else {
            obj = i->Create( *arguments ); 
         }
+        if( !obj ) {
+            // conversion error: the callback is not invoked
+            Py_DECREF( tuple );
+            PyErr_Print();
+            return;
+        }
         PyTuple_SetItem( tuple, t, obj ); 
     }
     //call Python function
@@ -23,13 +23,89 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <climits>
 #include "../include/PyContext.h"
 
 namespace qpy {
 
-PyContext::ConnectList PyContext::endpoints_;
-int PyContext::getterMethodId_ = -1;
-bool PyContext::signal_ = false;
+PyTypeObject PyContext::pyQMethodType_ = {
+    PyObject_HEAD_INIT(NULL)
+    0,                         /*ob_size*/
+    "qpy.Method",              /*tp_name*/
+    sizeof(PyQMethod),         /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    (destructor) PyQMethodDealloc, /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    0,                         /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    (ternaryfunc) PyQMethodCall, /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "QPy bound method",        /* tp_doc */
+};
+
+PyTypeObject PyContext::pyQObjectType_ = {
+    PyObject_HEAD_INIT(NULL)
+    0,                         /*ob_size*/
+    "qpy.QObject",             /*tp_name*/
+    sizeof(PyQObject),         /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    0,                         /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    0,                         /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /*tp_flags*/
+    "Base type of QPy QObject wrappers", /* tp_doc */
+};
+
+PyTypeObject PyContext::pyQPropertySetType_ = {
+    PyObject_HEAD_INIT(NULL)
+    0,                         /*ob_size*/
+    "qpy.PropertySet",         /*tp_name*/
+    sizeof(PyQPropertySet),    /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    (destructor) PyQPropertySetDealloc, /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    0,                         /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "Pre-resolved set of QObject properties", /* tp_doc */
+};
+
+PyContext::PyQObject* PyContext::freeList_ = 0;
+int PyContext::numFree_ = 0;
+int PyContext::numContexts_ = 0;
 
 const char* PyContext::Version() { return QPY_GIT_VERSION; }
 
@@ -42,83 +118,194 @@ PyTypeObject* PyContext::AddType( const QMetaObject* mo,
                                   const char* className,
                                   const char* doc ) {
     Type* pet = ExistingType( mo, module );
-    if( pet ) return &pet->pyType;
+    if( pet ) return &pet->pyQType.pyType;
+    if( PyType_Ready( &pyQObjectType_ ) < 0 || PyType_Ready( &pyQMethodType_ ) < 0
+        || PyType_Ready( &pyQPropertySetType_ ) < 0 ) {
+        throw std::runtime_error( "Cannot initialize base types" );
+        return 0;
+    }
+
+    // do we need this ? objects might be wrapping a pre-existing QObject
+    // not requiring construction; should be run-time configurable
+    if( checkConstructor && mo->constructorCount() < 1 ) {
+        throw std::logic_error( "No constructor available" );
+        return 0; // in case exceptions not enabled
+    }
 
     nameMapper.Init( *mo );
+    // methods can take and return pointers to the type itself
+    RegisterQObjectPointers( mo );
   
-    Type t;
-    t.metaObject = mo;
-    types_.push_back( t );
-    Type* pt = &types_.back();
+    Type* pt = new Type;
+    pt->metaObject = mo;
+    types_.push_back( pt );
+    typeIndex_.insert( TypeKey( mo, module ), pt );
     pt->pyContext = this;
     pt->className = className ? className : mo->className();
     assert( PyModule_GetName( module ) );
     pt->fullClassName = std::string( PyModule_GetName( module ) ) + "." + pt->className;
     if( doc) pt->doc = doc;
     pt->pyModule = module;
-    // do we need this ? objects might be wrapping a pre-existing QObject
-    // not requiring construction; should be run-time configurable
-    if( checkConstructor && mo->constructorCount() < 1 ) {
-        throw std::logic_error( "No constructor available" );
-        return 0; // in case exceptions not enabled
-    }
     for( int i = 0; i != mo->constructorCount(); ++i ) {
         QMetaMethod mm = mo->constructor( i );
-        pt->ctorParams.push_back( GenerateQArgWrappers( mm.parameterTypes() ) );
-                                 
+        pt->constructors.push_back( Method( mm,
+                                            GenerateQArgWrappers( mm.parameterTypes() ),
+                                            PyArgWrapper(),
+                                            mo,
+                                            i ) );
+        pt->ctorOverloads.Add( &pt->constructors.back() );
     }
-    int memberPos = 0;
+    // names are referenced through c_str() by the PyGetSetDef entries and
+    // descriptors reference PyGetSetDef entries: reserve enough space to never
+    // reallocate, lazy types add entries after type creation
+    pt->pyMethodNames.reserve( mo->methodCount() + mo->propertyCount() );
+    pt->pyMembers.reserve( mo->methodCount() + mo->propertyCount() + 1 );
+    // methods mapped to the same Python name are added to the same overload set
+    QHash< QString, int > overloadIndex;
     for( int i = 0; i != mo->methodCount(); ++i ) {
         QMetaMethod mm = mo->method( i );
         QString sig = mm.signature();
         if( !selectedMembers.isEmpty() && !selectedMembers.contains( sig ) ) continue;
-        pt->methods.push_back( Method( mm,
-                                       GenerateQArgWrappers( mm.parameterTypes() ),
-                                       GeneratePyArgWrapper( mm.typeName() ),
-                                       mo ) );
-        pt->pyMethodNames.push_back( nameMapper.signature( sig ).toStdString() );
-       
-        PyGetSetDef gs = { const_cast< char* >( pt->pyMethodNames.back().c_str() ),
-                           reinterpret_cast< getter >( PyQObjectGetter ),
-                           reinterpret_cast< setter >( PyQObjectSetter ),
-                           const_cast< char* >( nameMapper.methodDoc( sig ) ),
-                           reinterpret_cast< void* >( memberPos++ ) };
-        pt->pyMembers.push_back( gs );                                                        
-
+        const QString name = nameMapper.signature( sig );
+        if( nameMapper.returnView( sig ) ) pt->viewMethods.insert( i );
+        if( lazyTypes_ ) {
+            LazyMember& lm = pt->lazyMembers[ name.toAscii() ];
+            if( lm.methods.isEmpty() ) lm.doc = nameMapper.methodDoc( sig );
+            lm.methods.push_back( i );
+            continue;
+        }
+        if( !overloadIndex.contains( name ) ) {
+            overloadIndex[ name ] = pt->overloads.size();
+            pt->pyMembers.push_back( AddOverloads( *pt, name.toStdString(), nameMapper.methodDoc( sig ) ) );
+        }
+        AddMethod( *pt, pt->overloads[ overloadIndex[ name ] ], i );
     }
-    memberPos = 0;
     for( int i = 0; i != mo->propertyCount(); ++i ) {
         QMetaProperty mp = mo->property( i );
         if( !selectedMembers.isEmpty() && !selectedMembers.contains( mp.name() ) ) continue;
-        PyGetSetDef gs = { const_cast< char* >( qPrintable( nameMapper.property( mp.name() ) ) ),
-                           reinterpret_cast< getter >( PyQObjectGetter ),
-                           reinterpret_cast< setter >( PyQObjectSetter ),
-                           const_cast< char* >( nameMapper.propertyDoc( mp.name() ) ),
-                           reinterpret_cast< void* >( memberPos++ + pt->methods.size() ) };
-        pt->pyMembers.push_back( gs );                                                        
+        const QString name = nameMapper.property( mp.name() );
+        if( lazyTypes_ ) {
+            LazyMember& lm = pt->lazyMembers[ name.toAscii() ];
+            lm.property = i;
+            lm.doc = nameMapper.propertyDoc( mp.name() );
+            continue;
+        }
+        pt->pyMembers.push_back( AddProperty( *pt, name.toStdString(),
+                                              nameMapper.propertyDoc( mp.name() ), i ) );
     }
     //add sentinel!
     const PyGetSetDef gsd = { 0, 0, 0, 0, 0};
     pt->pyMembers.push_back( gsd );
 
-    pt->pyType = CreatePyType( *pt );
-    PyType_Ready( &pt->pyType );
-    pt->pyType.tp_new = PyQObjectNew;
-    PyObject* pyPtr = PyCapsule_New( pt, "qpy type info", 0 );
-    assert( pyPtr && "NULL pyPtr" );
-    assert( pt->pyType.tp_dict && "NULL dict" );
-
-    PY_CHECK( PyDict_SetItemString( pt->pyType.tp_dict, "__qpy_type_info__", pyPtr ) );
+    pt->pyQType.pyType = CreatePyType( *pt );
+    if( lazyTypes_ ) {
+        pt->pyQType.pyType.tp_getattro = PyQObjectGetAttr;
+        pt->pyQType.pyType.tp_setattro = PyQObjectSetAttr;
+    }
+    PyType_Ready( &pt->pyQType.pyType );
+    pt->pyQType.pyType.tp_new = PyQObjectNew;
+    pt->pyQType.type = pt;
+    assert( pt->pyQType.pyType.tp_dict && "NULL dict" );
 
-    Py_INCREF( reinterpret_cast< PyObject* >( &pt->pyType ) );
+    Py_INCREF( reinterpret_cast< PyObject* >( &pt->pyQType.pyType ) );
     if( PyModule_AddObject( module, pt->className.c_str(),
-                            reinterpret_cast< PyObject* >( &pt->pyType ) ) != 0 ) {
-        Py_DECREF( reinterpret_cast< PyObject* >( &pt->pyType ) );
+                            reinterpret_cast< PyObject* >( &pt->pyQType.pyType ) ) != 0 ) {
+        Py_DECREF( reinterpret_cast< PyObject* >( &pt->pyQType.pyType ) );
+        typeIndex_.remove( TypeKey( mo, module ) );
         types_.pop_back();
+        delete pt;
         throw std::runtime_error( "Cannot add object to module" );
         return 0;
     }
-    return &pt->pyType;
+    return &pt->pyQType.pyType;
+}
+
+//----------------------------------------------------------------------------
+PyGetSetDef PyContext::AddOverloads( Type& t, const std::string& name, const char* doc ) {
+    t.overloads.push_back( Overloads() );
+    t.pyMethodNames.push_back( name );
+    PyGetSetDef gs = { const_cast< char* >( t.pyMethodNames.back().c_str() ),
+                       reinterpret_cast< getter >( PyQObjectMethodGetter ),
+                       reinterpret_cast< setter >( PyQObjectMethodSetter ),
+                       const_cast< char* >( doc ),
+                       &t.overloads.back() };
+    return gs;
+}
+
+//----------------------------------------------------------------------------
+PyContext::Method PyContext::NewMethod( const Type& t, int methodIndex ) {
+    QMetaMethod mm = t.metaObject->method( methodIndex );
+    const QByteArray returnType = mm.typeName();
+    return Method( mm,
+                   GenerateQArgWrappers( mm.parameterTypes() ),
+                   t.viewMethods.contains( methodIndex )
+                       ? GenerateViewWrapper( returnType )
+                       : GeneratePyArgWrapper( returnType ),
+                   t.metaObject );
+}
+
+//----------------------------------------------------------------------------
+void PyContext::AddMethod( Type& t, Overloads& overloads, int methodIndex ) {
+    t.methods.push_back( NewMethod( t, methodIndex ) );
+    overloads.Add( &t.methods.back() );
+}
+
+//----------------------------------------------------------------------------
+PyGetSetDef PyContext::AddProperty( Type& t, const std::string& name, const char* doc,
+                                    int propertyIndex ) {
+    const QMetaProperty mp = t.metaObject->property( propertyIndex );
+    // use typed converters when available, QVariant otherwise
+    const ArgFactoryEntry* e = ResolveArgFactoryEntry( mp.typeName() );
+    const PyArgConstructor* pac = e ? e->pac : 0;
+    const QArgConstructor* qac = e ? e->qac : 0;
+    t.properties.push_back(
+        Property( mp, propertyIndex,
+                  PyArgWrapper( pac ), pac != 0,
+                  QArgWrapper( qac ), qac != 0 ) );
+    t.propertyIndex.insert( QByteArray( name.c_str() ), &t.properties.back() );
+    t.pyMethodNames.push_back( name );
+    PyGetSetDef gs = { const_cast< char* >( t.pyMethodNames.back().c_str() ),
+                       reinterpret_cast< getter >( PyQObjectPropertyGetter ),
+                       reinterpret_cast< setter >( PyQObjectPropertySetter ),
+                       const_cast< char* >( doc ),
+                       &t.properties.back() };
+    return gs;
+}
+
+//----------------------------------------------------------------------------
+bool PyContext::MaterializeMember( Type& t, const QByteArray& name ) {
+    LazyMembers::iterator i = t.lazyMembers.find( name );
+    if( i == t.lazyMembers.end() ) return false;
+    const LazyMember lm = i.value();
+    PyGetSetDef gs;
+    if( lm.property >= 0 ) {
+        gs = AddProperty( t, name.constData(), lm.doc, lm.property );
+    } else {
+        // create all the wrappers before modifying the type: if a type is
+        // unknown the member is left untouched and can be added after the
+        // type is registered
+        Methods methods;
+        for( QVector< int >::const_iterator m = lm.methods.begin(); m != lm.methods.end(); ++m ) {
+            methods.push_back( NewMethod( t, *m ) );
+        }
+        gs = AddOverloads( t, name.constData(), lm.doc );
+        for( Methods::const_iterator m = methods.begin(); m != methods.end(); ++m ) {
+            t.methods.push_back( *m );
+            t.overloads.back().Add( &t.methods.back() );
+        }
+    }
+    t.lazyMembers.remove( name );
+    // capacity reserved at type creation: no reallocation, descriptors
+    // of already materialized members remain valid
+    assert( t.pyMembers.size() < t.pyMembers.capacity() );
+    t.pyMembers.push_back( gs );
+    PyObject* descr = PyDescr_NewGetSet( &t.pyQType.pyType, &t.pyMembers.back() );
+    if( !descr ) return false;
+    const int r = PyDict_SetItemString( t.pyQType.pyType.tp_dict, name.constData(), descr );
+    Py_DECREF( descr );
+    // invalidate attribute cache of type and derived types
+    PyType_Modified( &t.pyQType.pyType );
+    return r == 0;
 }
 
 //----------------------------------------------------------------------------
@@ -142,6 +329,26 @@ PyMethodDef* PyContext::ModuleFunctions() {
           "Return pointer to embedded QObject" },
         { "tr",reinterpret_cast< PyCFunction >( PyQObjectTr), METH_VARARGS,
           "Translate string" },             
+        { "property_set", reinterpret_cast< PyCFunction >( PyQObjectPropertySet ), METH_VARARGS,
+          "Resolve property names of QObject or QObject type once; the returned "
+          "property set can be passed to get_properties and set_properties" },
+        { "get_properties", reinterpret_cast< PyCFunction >( PyQObjectGetProperties ), METH_VARARGS,
+          "Read properties from QObject; returns property name -> value dictionary" },
+        { "set_properties", reinterpret_cast< PyCFunction >( PyQObjectSetProperties ), METH_VARARGS,
+          "Write properties from property name -> value mapping or "
+          "from property set and sequence of values" },
+        { "gather", reinterpret_cast< PyCFunction >( PyQObjectGather ), METH_VARARGS,
+          "Read property from sequence of QObjects; returns array for numeric "
+          "properties, list otherwise" },
+        { "scatter", reinterpret_cast< PyCFunction >( PyQObjectScatter ), METH_VARARGS,
+          "Write property of sequence of QObjects from sequence or array of values" },
+        { "invoke_many", reinterpret_cast< PyCFunction >( PyQObjectInvokeMany ), METH_VARARGS,
+          "Invoke bound method once per argument tuple in sequence, or invoke "
+          "named method with optional argument tuple on each QObject in sequence; "
+          "returns list of results" },
+        { "construct_many", reinterpret_cast< PyCFunction >( PyQObjectConstructMany ), METH_VARARGS,
+          "Create QObjects of given type, from number of objects or sequence of "
+          "constructor argument tuples; returns list of objects" },
         {0}
     };
     return functions;
@@ -155,15 +362,22 @@ PyMethodDef* PyContext::ModuleFunctions() {
                                  bool pythonOwned,
                                  const QSet< QString >& selectedMembers,
                                  const PyMemberNameMapper& nameMapper ) {
-    static const bool CHECK_CONSTRUCTOR_OPTION = false;
-    PyTypeObject* pt = AddType( qobj->metaObject(), typeModule,
-                                CHECK_CONSTRUCTOR_OPTION, selectedMembers, nameMapper );
-    assert( pt );
-    PyQObject* obj = reinterpret_cast< PyQObject* >( 
-                            PyObject_CallObject( reinterpret_cast< PyObject* >( pt ), 0  ) );
-    obj->foreignOwned = !pythonOwned;
-    obj->obj = qobj;
-    obj->pyModule = targetModule;
+    if( !qobj ) Py_RETURN_NONE;
+    PyQObject* obj = wrapperCache_.Find( qobj );
+    if( obj ) {
+        Py_INCREF( obj );
+    } else {
+        static const bool CHECK_CONSTRUCTOR_OPTION = false;
+        PyTypeObject* pt = AddType( qobj->metaObject(), typeModule,
+                                    CHECK_CONSTRUCTOR_OPTION, selectedMembers, nameMapper );
+        assert( pt );
+        // do not go through tp_init: the QObject already exists
+        obj = reinterpret_cast< PyQObject* >( PyQObjectNew( pt, 0, 0 ) );
+        if( !obj ) return 0;
+        obj->foreignOwned = !pythonOwned;
+        obj->obj = qobj;
+        wrapperCache_.Insert( obj );
+    }
     // this method is might be called also to wrap QObject* returned by methods; in this case
     // it should not add the object explicitly into the module
     if( instanceName ) {
@@ -182,18 +396,53 @@ void PyContext::InitArgFactory() {
     RegisterType< StringQArgConstructor, StringPyArgConstructor >( QMetaType::QString );
     RegisterType< FloatQArgConstructor, FloatPyArgConstructor >( QMetaType::Float );
     RegisterType< DoubleQArgConstructor, DoublePyArgConstructor >( QMetaType::Double );
+    RegisterConverter< bool, BoolConverter >();
+    RegisterConverter< uint, UIntConverter >();
+    RegisterConverter< qlonglong, LongLongConverter >();
+    RegisterConverter< qulonglong, ULongLongConverter >();
+    RegisterConverter< QChar, CharConverter >();
+    RegisterConverter< QByteArray, ByteArrayConverter >();
+    // arguments reference the Python buffer without copy
+    RegisterType< ByteArrayQArgConstructor, 
+                  ConverterPyArgConstructor< QByteArray, ByteArrayConverter > >( QMetaType::QByteArray,
+                                                                                  true );
+    RegisterConverter< QStringList, StringListConverter >();
+    RegisterConverter< QDate, DateConverter >();
+    RegisterConverter< QTime, TimeConverter >();
+    RegisterConverter< QDateTime, DateTimeConverter >();
+    RegisterConverter< QUrl, UrlConverter >();
+    RegisterConverter< QPoint, PointConverter >();
+    RegisterConverter< QPointF, PointFConverter >();
+    RegisterConverter< QSize, SizeConverter >();
+    RegisterConverter< QSizeF, SizeFConverter >();
+    RegisterConverter< QRect, RectConverter >();
+    RegisterConverter< QRectF, RectFConverter >();
+    RegisterNumericContainers< short >( "short" );
+    RegisterNumericContainers< int >( "int" );
+    RegisterNumericContainers< qint64 >( "qint64" );
+    RegisterNumericContainers< float, NumericVectorConverter< float > >( "float" );
+    RegisterNumericContainers< double, NumericVectorConverter< double > >( "double" );
+    RegisterConverter< QVariantList, VariantContainerConverter< QVariantList > >(
+        VariantContainerConverter< QVariantList >( this ) );
+    RegisterConverter< QVariantMap, VariantContainerConverter< QVariantMap > >(
+        VariantContainerConverter< QVariantMap >( this ) );
+    RegisterConverter< QVariantHash, VariantContainerConverter< QVariantHash > >(
+        VariantContainerConverter< QVariantHash >( this ) );
+    RegisterVariantView< QVariantList >();
+    RegisterVariantView< QVariantMap >();
+    RegisterVariantView< QVariantHash >();
 };
 
 //----------------------------------------------------------------------------
 void PyContext::InitQVariantPyObjectMaps() {
     const bool FOREIGN_OWNED_OPTION = true;
-    qvariantToPyObject_[ QVariant::Int ] = new IntQVariantToPyObject( FOREIGN_OWNED_OPTION );
-    qvariantToPyObject_[ QVariant::Double ] = new DoubleQVariantToPyObject( FOREIGN_OWNED_OPTION );
-    qvariantToPyObject_[ QVariant::String ] = new StringQVariantToPyObject( FOREIGN_OWNED_OPTION );
+    RegisterQVariantToPyObject( QVariant::Int, new IntQVariantToPyObject( FOREIGN_OWNED_OPTION ) );
+    RegisterQVariantToPyObject( QVariant::Double, new DoubleQVariantToPyObject( FOREIGN_OWNED_OPTION ) );
+    RegisterQVariantToPyObject( QVariant::String, new StringQVariantToPyObject( FOREIGN_OWNED_OPTION ) );
 
-    pyObjectToQVariant_[ QVariant::Int ] = new IntPyObjectToQVariant( FOREIGN_OWNED_OPTION );
-    pyObjectToQVariant_[ QVariant::Double ] = new DoublePyObjectToQVariant( FOREIGN_OWNED_OPTION );
-    pyObjectToQVariant_[ QVariant::String ] = new StringPyObjectToQVariant( FOREIGN_OWNED_OPTION );
+    RegisterPyObjectToQVariant( QVariant::Int, new IntPyObjectToQVariant( FOREIGN_OWNED_OPTION ) );
+    RegisterPyObjectToQVariant( QVariant::Double, new DoublePyObjectToQVariant( FOREIGN_OWNED_OPTION ) );
+    RegisterPyObjectToQVariant( QVariant::String, new StringPyObjectToQVariant( FOREIGN_OWNED_OPTION ) );
 };
 
 
@@ -202,35 +451,179 @@ PyContext::QArgWrappers PyContext::GenerateQArgWrappers( const ArgumentTypes& at
     QArgWrappers aw;
     ///@warning moc *always* adds a QObject* to any constructor!!!
     for( ArgumentTypes::const_iterator i = at.begin(); i != at.end(); ++i ) {
-        if( !argFactory_.contains( *i ) 
-            || dynamic_cast< const NoQArgConstructor* >( argFactory_[ *i ].QArgCtor() ) ) {
+        const ArgFactoryEntry* e = ResolveArgFactoryEntry( *i );
+        if( !e || !e->qac ) {
             throw std::logic_error( ( "Type " + QString( *i ) + " unknown" ).toStdString() );
         } else {
-            aw.push_back( QArgWrapper( argFactory_[ *i ].MakeQArgConstructor() ) );
+            aw.push_back( QArgWrapper( e->qac ) );
         }
     }
     return aw;
 }   
 
 //----------------------------------------------------------------------------    
-PyArgWrapper PyContext::GeneratePyArgWrapper( QString typeName ) {
-    typeName = typeName.isEmpty() ? QMetaType::typeName( QMetaType::Void ) : typeName;
-    if( !argFactory_.contains( typeName )  
-        || dynamic_cast< const NoPyArgConstructor* >( argFactory_[ typeName ].PyArgCtor() ) ) {
-            throw std::logic_error( ( "Type " + typeName + " unknown" ).toStdString() );
+PyArgWrapper PyContext::GeneratePyArgWrapper( const QByteArray& typeName ) {
+    const ArgFactoryEntry* e = 
+        ResolveArgFactoryEntry( typeName.isEmpty() ? QByteArray( QMetaType::typeName( QMetaType::Void ) )
+                                                : typeName );
+    if( !e || !e->pac ) {
+        throw std::logic_error( ( "Type " + QString( typeName ) + " unknown" ).toStdString() );
         return PyArgWrapper();
     } else {
-        return PyArgWrapper( argFactory_[ typeName ].MakePyArgConstructor() );
+        return PyArgWrapper( e->pac );
     }
 }    
 
+//----------------------------------------------------------------------------
+void PyContext::RegisterQObjectPointers( const QMetaObject* mo ) {
+    for( ; mo && mo != &QObject::staticMetaObject; mo = mo->superClass() ) {
+        qobjectClasses_.insert( mo->className() );
+        const QByteArray name = QByteArray( mo->className() ) + "*";
+        if( !typeIds_.contains( name ) ) RegisterQObjectPointer( name );
+    }
+}
+
+//----------------------------------------------------------------------------
+const PyContext::ArgFactoryEntry* PyContext::RegisterQObjectPointer( const QByteArray& typeName ) {
+    int id = QMetaType::type( typeName.constData() );
+    if( id == 0 ) {
+        // same as qRegisterMetaType< T* >: construct and delete a pointer
+        id = QMetaType::registerType( typeName.constData(),
+            reinterpret_cast< QMetaType::Destructor >( qMetaTypeDeleteHelper< QObject* > ),
+            reinterpret_cast< QMetaType::Constructor >( qMetaTypeConstructHelper< QObject* > ) );
+    }
+    const QByteArray className = typeName.left( typeName.size() - 1 );
+    RegisterType( typeName, id, new TypedObjectStarQArgConstructor( className ),
+                  new TypedObjectStarPyArgConstructor( id, className, this ), false );
+    return FindArgFactoryEntry( typeName );
+}
+
+//----------------------------------------------------------------------------
+const PyContext::ArgFactoryEntry* PyContext::ResolveArgFactoryEntry( const QByteArray& typeName ) {
+    const ArgFactoryEntry* e = FindArgFactoryEntry( typeName );
+    if( e || !typeName.endsWith( '*' ) ) return e;
+    // only pointers to class names: 'Class*' or 'Namespace::Class*'; names
+    // of types known to QMetaType such as 'char' are not classes
+    const QByteArray className = typeName.left( typeName.size() - 1 );
+    if( className.isEmpty() || QMetaType::type( className.constData() ) != 0 ) return 0;
+    for( int i = 0; i != className.size(); ++i ) {
+        const char c = className[ i ];
+        if( !( c >= 'a' && c <= 'z' ) && !( c >= 'A' && c <= 'Z' ) && c != '_'
+            && c != ':' && !( i > 0 && c >= '0' && c <= '9' ) ) return 0;
+    }
+    return RegisterQObjectPointer( typeName );
+}
+
+//----------------------------------------------------------------------------
+PyArgWrapper PyContext::GenerateViewWrapper( const QByteArray& typeName ) {
+    const int id = typeName.isEmpty() ? 0 : QMetaType::type( typeName.constData() );
+    if( id > 0 && id < viewArgConstructors_.size() && viewArgConstructors_[ id ] ) {
+        return PyArgWrapper( viewArgConstructors_[ id ] );
+    }
+    return GeneratePyArgWrapper( typeName );
+}
+
+//----------------------------------------------------------------------------
+const PyContext::Method* PyContext::Overloads::Resolve( PyObject* args ) const {
+    const int sz = int( PyTuple_GET_SIZE( args ) );
+    if( sz >= byArity_.size() || byArity_[ sz ].isEmpty() ) {
+        if( all_.isEmpty() ) {
+            RaisePyError( "Cannot find constructor" );
+        } else {
+            RaisePyError( qPrintable( QString( "%1::%2: no overload accepts %3 arguments" )
+                          .arg( all_.front()->metaObject_->className() )
+                          .arg( all_.front()->metaMethod_.signature() )
+                          .arg( sz ) ), PyExc_TypeError );
+        }
+        return 0;
+    }
+    const QVector< const Method* >& candidates = byArity_[ sz ];
+    if( candidates.size() == 1 ) return candidates.front();
+    // select the method with the highest sum of type matches; stop at the
+    // first method whose parameter types all match exactly
+    const Method* best = 0;
+    int bestScore = 0;
+    for( QVector< const Method* >::const_iterator m = candidates.begin();
+         m != candidates.end(); ++m ) {
+        int score = 0;
+        int i = 0;
+        for( ; i != sz; ++i ) {
+            const int s = ( *m )->argumentWrappers_[ i ].Check( PyTuple_GET_ITEM( args, i ) );
+            if( s == 0 ) break;
+            score += s;
+        }
+        if( i != sz || score <= bestScore ) continue;
+        best = *m;
+        bestScore = score;
+        if( score == 2 * sz ) break;
+    }
+    if( !best ) {
+        RaisePyError( qPrintable( QString( "%1::%2: arguments do not match any overload" )
+                      .arg( candidates.front()->metaObject_->className() )
+                      .arg( candidates.front()->metaMethod_.signature() ) ), PyExc_TypeError );
+    }
+    return best;
+}
+
+//----------------------------------------------------------------------------
+const PyContext::Method* PyContext::Overloads::Signal() const {
+    for( QVector< const Method* >::const_iterator m = all_.begin(); m != all_.end(); ++m ) {
+        if( ( *m )->metaMethod_.methodType() == QMetaMethod::Signal ) return *m;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+const PyContext::Method* PyContext::Overloads::Slot( const Method& signal ) const {
+    for( QVector< const Method* >::const_iterator m = all_.begin(); m != all_.end(); ++m ) {
+        if( QMetaObject::checkConnectArgs( signal.metaMethod_.signature(),
+                                           ( *m )->metaMethod_.signature() ) ) return *m;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+void PyContext::WrapperCache::Insert( PyQObject* pyqobj ) {
+    static const int destroyedIndex =
+        QObject::staticMetaObject.indexOfSignal( "destroyed(QObject*)" );
+    wrappers_[ pyqobj->obj ] = pyqobj;
+    QMetaObject::connect( pyqobj->obj, destroyedIndex, this, metaObject()->methodCount(),
+                          Qt::DirectConnection );
+}
+
+//----------------------------------------------------------------------------
+void PyContext::WrapperCache::Remove( PyQObject* pyqobj ) {
+    static const int destroyedIndex =
+        QObject::staticMetaObject.indexOfSignal( "destroyed(QObject*)" );
+    if( wrappers_.value( pyqobj->obj, 0 ) != pyqobj ) return;
+    wrappers_.remove( pyqobj->obj );
+    QMetaObject::disconnect( pyqobj->obj, destroyedIndex, this, metaObject()->methodCount() );
+}
+
+//----------------------------------------------------------------------------
+int PyContext::WrapperCache::qt_metacall( QMetaObject::Call c, int id, void** arguments ) {
+    id = QObject::qt_metacall( c, id, arguments );
+    if( id < 0 || c != QMetaObject::InvokeMetaMethod ) return id;
+    // destroyed( QObject* ): the wrapper is left pointing to a NULL QObject;
+    // the entry is removed before the memory of the QObject can be reused
+    // while or after the interpreter is finalized no other thread runs Python
+    // code and the GIL cannot be acquired; wrappers still in the cache have not
+    // been deallocated, since deallocation removes them
+    const bool initialized = Py_IsInitialized();
+    PyGILState_STATE gil = PyGILState_UNLOCKED;
+    if( initialized ) gil = PyGILState_Ensure();
+    PyQObject* pyqobj = wrappers_.take( *reinterpret_cast< QObject** >( arguments[ 1 ] ) );
+    if( pyqobj ) pyqobj->obj = 0;
+    if( initialized ) PyGILState_Release( gil );
+    return -1;
+}
+
 //============================================================================
 // Python interface
 //============================================================================
 
 //----------------------------------------------------------------------------
 PyObject* PyContext::PyQObjectConnect( PyObject* self, PyObject* args ) {
-    signal_ = false;
     PyObject* sourceObject = 0;
     const char* sourceMethod = 0;
     const char* targetMethod = 0;
@@ -241,12 +634,9 @@ PyObject* PyContext::PyQObjectConnect( PyObject* self, PyObject* args ) {
     int miTarget = -1;
     int mi = -1;
     bool qtobjects = false;
-    struct Clear{
-        ~Clear() { endpoints_.clear(); }
-    } CLEAR_ENDPOINTS;
     if( PyTuple_Size( args ) == 3 ) {
         PyArg_ParseTuple( args, "OsO", &sourceObject, &sourceMethod, &targetFunction );
-        if( PyObject_HasAttrString( sourceObject, "__qpy_qobject_tag__" ) ) {
+        if( IsQObject( sourceObject ) ) {
             pyqobj = reinterpret_cast< PyQObject* >( sourceObject );       
             mi = pyqobj->type->metaObject->indexOfMethod( sourceMethod ); 
         } else {
@@ -256,27 +646,39 @@ PyObject* PyContext::PyQObjectConnect( PyObject* self, PyObject* args ) {
     } else if( PyTuple_Size( args ) == 2 ) {
         PyObject* sourceMethodFunction = 0;
         PyArg_ParseTuple( args, "OO", &sourceMethodFunction, &targetFunction );
-        if( endpoints_.size() > 1 ) {
-            pyqobjTarget = endpoints_.back().pyqobj;
-            miTarget = endpoints_.back().methodId;
-            endpoints_.pop_back();
+        if( !PyObject_TypeCheck( sourceMethodFunction, &pyQMethodType_ ) ) {
+            RaisePyError( "Not a PyQObject method", PyExc_TypeError );
+            return 0;
+        }
+        PyQMethod* source = reinterpret_cast< PyQMethod* >( sourceMethodFunction );
+        pyqobj = source->self;
+        const Method* signal = source->overloads->Signal();
+        if( !signal ) signal = source->overloads->First();
+        mi = signal->index_;
+        if( PyObject_TypeCheck( targetFunction, &pyQMethodType_ ) ) {
+            PyQMethod* target = reinterpret_cast< PyQMethod* >( targetFunction );
+            pyqobjTarget = target->self;
+            const Method* slot = target->overloads->Slot( *signal );
+            if( !slot ) {
+                RaisePyError( qPrintable( QString( "No slot compatible with signal %1" )
+                              .arg( signal->metaMethod_.signature() ) ), PyExc_TypeError );
+                return 0;
+            }
+            miTarget = slot->index_;
             qtobjects = true;
         }
-        pyqobj = endpoints_.back().pyqobj;
-        mi = endpoints_.back().methodId;
-        endpoints_.pop_back();
     } else if( PyTuple_Size( args ) == 4 ) {
         PyArg_ParseTuple( args, "OsOs", &sourceObject, &sourceMethod, &targetObject, &targetMethod );
-        if( PyObject_HasAttrString( sourceObject, "__qpy_qobject_tag__" ) ) {
+        if( IsQObject( sourceObject ) ) {
             pyqobj = reinterpret_cast< PyQObject* >( sourceObject );       
             mi = pyqobj->type->metaObject->indexOfMethod( sourceMethod ); 
         } else {
             RaisePyError( "Not a PyQObject" );
             return 0;
         }
-        if( PyObject_HasAttrString( targetObject, "__qpy_qobject_tag__" ) ) {
+        if( IsQObject( targetObject ) ) {
             pyqobjTarget = reinterpret_cast< PyQObject* >( targetObject );       
-            miTarget = pyqobj->type->metaObject->indexOfMethod( targetMethod ); 
+            miTarget = pyqobjTarget->type->metaObject->indexOfMethod( targetMethod ); 
         } else {
             RaisePyError( "Not a PyQObject" );
             return 0;
@@ -299,7 +701,7 @@ PyObject* PyContext::PyQObjectConnect( PyObject* self, PyObject* args ) {
         QList< PyArgWrapper > types;
         for( QList< QByteArray >::const_iterator i = params.begin();
              i != params.end(); ++i ) {
-            types.push_back( pyqobj->type->pyContext->GeneratePyArgWrapper( i->constData() ) ); 
+            types.push_back( pyqobj->type->pyContext->GeneratePyArgWrapper( *i ) ); 
         }
         pyqobj->type->pyContext->dispatcher_.Connect( pyqobj->obj, mi, types, targetFunction,
                                                       pyqobj->type->pyModule );  
@@ -310,22 +712,19 @@ PyObject* PyContext::PyQObjectConnect( PyObject* self, PyObject* args ) {
 
 //----------------------------------------------------------------------------
 PyObject* PyContext::PyQObjectDisconnect( PyObject* self, PyObject* args ) {
-    signal_ = false;
     PyObject* sourceObject = 0;
     const char* sourceMethod = 0;
     PyObject* targetFunction = 0;
     PyQObject* srcQObject = 0;
-    struct Clear{
-        ~Clear() { endpoints_.clear(); }
-    } CLEAR_ENDPOINTS;
     if( PyTuple_Size( args ) == 3 ) {
         PyArg_ParseTuple( args, "OsO", &sourceObject, &sourceMethod, &targetFunction );
-        if( PyObject_HasAttrString( sourceObject, "__qpy_qobject_tag__" ) ) {
+        if( IsQObject( sourceObject ) ) {
             PyQObject* pyqobj = reinterpret_cast< PyQObject* >( sourceObject );
             const int mi = pyqobj->type->metaObject->indexOfMethod( sourceMethod );
             if( mi < 0 ) {
                 RaisePyError( ( std::string( "Cannot find method" ) 
                             + std::string( sourceMethod ) ).c_str() );
+                return 0;
             }
             pyqobj->type->pyContext->dispatcher_.Disconnect( pyqobj->obj, mi, targetFunction );
             Py_RETURN_NONE;
@@ -334,25 +733,27 @@ PyObject* PyContext::PyQObjectDisconnect( PyObject* self, PyObject* args ) {
             return 0;
         }
     } else if( PyTuple_Size( args ) == 2 ) {
-        PyQObject* pyqobj = 0;
-        PyQObject* pyqobjTarget = 0;
-        bool qtobjects = false;
-        int mi = -1;
-        int miTarget = -1;
-        if( endpoints_.size() > 1 ) {
-            pyqobjTarget = endpoints_.back().pyqobj;
-            miTarget = endpoints_.back().methodId;
-            endpoints_.pop_back();
-            qtobjects = true;
+        PyObject* sourceMethodFunction = 0;
+        PyArg_ParseTuple( args, "OO", &sourceMethodFunction, &targetFunction );
+        if( !PyObject_TypeCheck( sourceMethodFunction, &pyQMethodType_ ) ) {
+            RaisePyError( "Not a PyQObject method", PyExc_TypeError );
+            return 0;
         }
-        pyqobj = endpoints_.back().pyqobj;
-        mi = endpoints_.back().methodId;
-        endpoints_.pop_back();
-        if( qtobjects ) {
-            QMetaObject::disconnect( pyqobj->obj, mi, pyqobjTarget->obj, miTarget );
+        PyQMethod* source = reinterpret_cast< PyQMethod* >( sourceMethodFunction );
+        PyQObject* pyqobj = source->self;
+        const Method* signal = source->overloads->Signal();
+        if( !signal ) signal = source->overloads->First();
+        const int mi = signal->index_;
+        if( PyObject_TypeCheck( targetFunction, &pyQMethodType_ ) ) {
+            PyQMethod* target = reinterpret_cast< PyQMethod* >( targetFunction );
+            const Method* slot = target->overloads->Slot( *signal );
+            if( !slot ) {
+                RaisePyError( qPrintable( QString( "No slot compatible with signal %1" )
+                              .arg( signal->metaMethod_.signature() ) ), PyExc_TypeError );
+                return 0;
+            }
+            QMetaObject::disconnect( pyqobj->obj, mi, target->self->obj, slot->index_ );
         } else {
-            PyObject* dummy = 0;
-            PyArg_ParseTuple( args, "OO", &dummy, &targetFunction );    
             pyqobj->type->pyContext->dispatcher_.Disconnect( pyqobj->obj, mi, targetFunction );
         }
         Py_RETURN_NONE;
@@ -366,16 +767,16 @@ PyObject* PyContext::PyQObjectDisconnect( PyObject* self, PyObject* args ) {
         int mi = -1;
         int miTarget = -1;
         PyArg_ParseTuple( args, "OsOs", &sourceObject, &sourceMethod, &targetObject, &targetMethod );
-        if( PyObject_HasAttrString( sourceObject, "__qpy_qobject_tag__" ) ) {
+        if( IsQObject( sourceObject ) ) {
             pyqobj = reinterpret_cast< PyQObject* >( sourceObject );       
             mi = pyqobj->type->metaObject->indexOfMethod( sourceMethod ); 
         } else {
             RaisePyError( "Not a PyQObject" );
             return 0;
         }
-        if( PyObject_HasAttrString( targetObject, "__qpy_qobject_tag__" ) ) {
+        if( IsQObject( targetObject ) ) {
             pyqobjTarget = reinterpret_cast< PyQObject* >( targetObject );       
-            miTarget = pyqobj->type->metaObject->indexOfMethod( targetMethod ); 
+            miTarget = pyqobjTarget->type->metaObject->indexOfMethod( targetMethod ); 
         } else {
             RaisePyError( "Not a PyQObject" );
             return 0;
@@ -392,7 +793,7 @@ PyObject* PyContext::PyQObjectDisconnect( PyObject* self, PyObject* args ) {
 PyObject* PyContext::PyQObjectIsForeignOwned( PyObject* self, PyObject* args ) {
     PyObject* obj = 0;
     PyArg_ParseTuple( args, "O", &obj );
-    if( PyObject_HasAttrString( obj, "__qpy_qobject_tag__" ) ) {
+    if( IsQObject( obj ) ) {
         PyQObject* pyqobj = reinterpret_cast< PyQObject* >( obj );
         return PyBool_FromLong( int( pyqobj->foreignOwned ) );
     } else {
@@ -405,7 +806,7 @@ PyObject* PyContext::PyQObjectIsForeignOwned( PyObject* self, PyObject* args ) {
 PyObject* PyContext::PyQObjectIsQObject( PyObject* self, PyObject* args ) {
     PyObject* obj = 0;
     PyArg_ParseTuple( args, "O", &obj );
-    if( PyObject_HasAttrString( obj, "__qpy_qobject_tag__" ) ) {
+    if( IsQObject( obj ) ) {
         return PyBool_FromLong( 1 ); 
     } else {
         return PyBool_FromLong( 0 );
@@ -416,7 +817,7 @@ PyObject* PyContext::PyQObjectIsQObject( PyObject* self, PyObject* args ) {
 PyObject* PyContext::PyQObjectAcquire( PyObject* self, PyObject* args ) {
     PyObject* obj = 0;
     PyArg_ParseTuple( args, "O", &obj );
-    if( PyObject_HasAttrString( obj, "__qpy_qobject_tag__" ) ) {
+    if( IsQObject( obj ) ) {
         PyQObject* pyqobj = reinterpret_cast< PyQObject* >( obj );
         pyqobj->foreignOwned = false;
         Py_RETURN_NONE;
@@ -430,7 +831,7 @@ PyObject* PyContext::PyQObjectAcquire( PyObject* self, PyObject* args ) {
 PyObject* PyContext::PyQObjectRelease( PyObject* self, PyObject* args ) {
     PyObject* obj = 0;
     PyArg_ParseTuple( args, "O", &obj );
-    if( PyObject_HasAttrString( obj, "__qpy_qobject_tag__" ) ) {
+    if( IsQObject( obj ) ) {
         PyQObject* pyqobj = reinterpret_cast< PyQObject* >( obj );
         pyqobj->foreignOwned = true;
         Py_RETURN_NONE;
@@ -444,7 +845,7 @@ PyObject* PyContext::PyQObjectRelease( PyObject* self, PyObject* args ) {
 PyObject* PyContext::PyQObjectPtr( PyObject* self, PyObject* args ) {
     PyObject* obj = 0;
     PyArg_ParseTuple( args, "O", &obj );
-    if( PyObject_HasAttrString( obj, "__qpy_qobject_tag__" ) ) {
+    if( IsQObject( obj ) ) {
         PyQObject* pyqobj = reinterpret_cast< PyQObject* >( obj );
         return PyLong_FromVoidPtr( pyqobj->obj );
     } else {
@@ -454,114 +855,862 @@ PyObject* PyContext::PyQObjectPtr( PyObject* self, PyObject* args ) {
 }
 
 //----------------------------------------------------------------------------
-PyObject* PyContext::PyQObjectGetter( PyQObject* qobj, void* closure /*method id*/ ) {
-    const int id = int( reinterpret_cast< size_t >( closure ) );
-    if( id < qobj->type->methods.size() ) {
-        if( qobj->obj->metaObject()->method( id ).methodType() == QMetaMethod::Signal ) {
-            signal_ = true;
+const PyContext::Property* PyContext::FindProperty( Type& t, PyObject* name ) {
+    const char* n = PyString_AsString( name );
+    if( !n ) return 0;
+    const Property* p = t.propertyIndex.value( n, 0 );
+    if( !p && t.lazyMembers.contains( n ) ) {
+        try {
+            if( !t.pyContext->MaterializeMember( t, n ) ) return 0;
+        } catch( const std::exception& e ) {
+            RaisePyError( e.what() );
+            return 0;
         }
-        if( signal_ ) endpoints_.push_back( ConnectEntry( qobj, id ) );
-        getterMethodId_ = id;
-        Py_INCREF( qobj->invoke );
-        return qobj->invoke;
-    } else {
-        QMetaProperty p = qobj->obj->metaObject()->property( id - qobj->type->methods.size() );
-        if( !p.isReadable() ) {
-            RaisePyError( qPrintable( "Cannot read property '" + QString( p.name() ) + "'" ) );
+        p = t.propertyIndex.value( n, 0 );
+    }
+    if( !p ) {
+        RaisePyError( qPrintable( QString( "%1 has no property '%2'" )
+                      .arg( t.className.c_str() ).arg( n ) ), PyExc_AttributeError );
+    }
+    return p;
+}
+
+//----------------------------------------------------------------------------
+PyContext::PyQPropertySet* PyContext::ResolveProperties( Type& t, PyObject* names ) {
+    PyObject* seq = PySequence_Fast( names, "Sequence of property names required" );
+    if( !seq ) return 0;
+    const int sz = int( PySequence_Fast_GET_SIZE( seq ) );
+    PyQPropertySet* ps = PyObject_New( PyQPropertySet, &pyQPropertySetType_ );
+    if( !ps ) {
+        Py_DECREF( seq );
+        return 0;
+    }
+    ps->type = &t;
+    ps->properties = new QVector< const Property* >( sz );
+    ps->names = PyTuple_New( sz );
+    if( !ps->names ) {
+        Py_DECREF( seq );
+        Py_DECREF( ps );
+        return 0;
+    }
+    for( int i = 0; i != sz; ++i ) {
+        PyObject* name = PySequence_Fast_GET_ITEM( seq, i );
+        const Property* p = FindProperty( t, name );
+        if( !p ) {
+            Py_DECREF( seq );
+            Py_DECREF( ps );
             return 0;
         }
-        if( !qobj->type->pyContext->qvariantToPyObject_.contains( p.type() ) ) {
-            RaisePyError( qPrintable( "Type " + QString( p.typeName() ) + " not supported" ) );
+        ( *ps->properties )[ i ] = p;
+        Py_INCREF( name );
+        PyTuple_SET_ITEM( ps->names, i, name );
+    }
+    Py_DECREF( seq );
+    return ps;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectPropertySet( PyObject* self, PyObject* args ) {
+    PyObject* obj = 0;
+    PyObject* names = 0;
+    if( !PyArg_ParseTuple( args, "OO", &obj, &names ) ) return 0;
+    if( IsQObject( obj ) ) {
+        return reinterpret_cast< PyObject* >(
+            ResolveProperties( *reinterpret_cast< PyQObject* >( obj )->type, names ) );
+    } 
+    if( PyType_Check( obj ) 
+        && PyType_IsSubtype( reinterpret_cast< PyTypeObject* >( obj ), &pyQObjectType_ ) 
+        && obj != reinterpret_cast< PyObject* >( &pyQObjectType_ ) ) {
+        PyTypeObject* p = reinterpret_cast< PyTypeObject* >( obj );
+        while( p->tp_base != &pyQObjectType_ ) p = p->tp_base;
+        return reinterpret_cast< PyObject* >(
+            ResolveProperties( *reinterpret_cast< PyQType* >( p )->type, names ) );
+    }
+    RaisePyError( "Not a PyQObject or PyQObject type", PyExc_TypeError );
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectGetProperties( PyObject* self, PyObject* args ) {
+    PyObject* obj = 0;
+    PyObject* names = 0;
+    if( !PyArg_ParseTuple( args, "OO", &obj, &names ) ) return 0;
+    if( !IsQObject( obj ) ) {
+        RaisePyError( "Not a PyQObject", PyExc_TypeError );
+        return 0;
+    }
+    PyQObject* pyqobj = reinterpret_cast< PyQObject* >( obj );
+    PyQPropertySet* ps = 0;
+    if( PyObject_TypeCheck( names, &pyQPropertySetType_ ) ) {
+        ps = reinterpret_cast< PyQPropertySet* >( names );
+        if( !PyObject_TypeCheck( obj, &ps->type->pyQType.pyType ) ) {
+            RaisePyError( "Property set does not match object type", PyExc_TypeError );
+            return 0;
+        }
+        Py_INCREF( ps );
+    } else {
+        ps = ResolveProperties( *pyqobj->type, names );
+        if( !ps ) return 0;
+    }
+    PyObject* d = PyDict_New();
+    const int sz = ps->properties->size();
+    for( int i = 0; d && i != sz; ++i ) {
+        PyObject* v = ReadProperty( pyqobj, *( *ps->properties )[ i ] );
+        if( !v || PyDict_SetItem( d, PyTuple_GET_ITEM( ps->names, i ), v ) != 0 ) {
+            Py_CLEAR( d );
+        }
+        Py_XDECREF( v );
+    }
+    Py_DECREF( ps );
+    return d;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectSetProperties( PyObject* self, PyObject* args ) {
+    PyObject* obj = 0;
+    PyObject* arg = 0;
+    PyObject* values = 0;
+    if( !PyArg_ParseTuple( args, "OO|O", &obj, &arg, &values ) ) return 0;
+    if( !IsQObject( obj ) ) {
+        RaisePyError( "Not a PyQObject", PyExc_TypeError );
+        return 0;
+    }
+    PyQObject* pyqobj = reinterpret_cast< PyQObject* >( obj );
+    if( !values ) {
+        // name -> value mapping
+        if( !PyMapping_Check( arg ) || !PyObject_HasAttrString( arg, "items" ) ) {
+            RaisePyError( "Mapping required", PyExc_TypeError );
             return 0;
         }
-        return qobj->type->pyContext->qvariantToPyObject_[ p.type() ]->Create( p.read( qobj->obj ) );
+        PyObject* list = PyMapping_Items( arg );
+        if( !list ) return 0;
+        // items() is not required to return a list
+        PyObject* items = PySequence_Fast( list, "Sequence of mapping items required" );
+        Py_DECREF( list );
+        if( !items ) return 0;
+        const int sz = int( PySequence_Fast_GET_SIZE( items ) );
+        QVector< const Property* > props( sz );
+        QVector< PyObject* > v( sz );
+        int r = 0;
+        for( int i = 0; r == 0 && i != sz; ++i ) {
+            PyObject* item = PySequence_Fast_GET_ITEM( items, i );
+            if( !PyTuple_Check( item ) || PyTuple_GET_SIZE( item ) != 2 ) {
+                RaisePyError( "Mapping items must be (name, value) pairs", PyExc_TypeError );
+                r = -1;
+                break;
+            }
+            props[ i ] = FindProperty( *pyqobj->type, PyTuple_GET_ITEM( item, 0 ) );
+            v[ i ] = PyTuple_GET_ITEM( item, 1 );
+            if( !props[ i ] ) r = -1;
+        }
+        if( r == 0 ) r = WriteProperties( pyqobj, props, v.constData() );
+        Py_DECREF( items );
+        if( r != 0 ) return 0;
+        Py_RETURN_NONE;
+    }
+    // property set and sequence of values
+    if( !PyObject_TypeCheck( arg, &pyQPropertySetType_ ) ) {
+        RaisePyError( "Property set required", PyExc_TypeError );
+        return 0;
+    }
+    PyQPropertySet* ps = reinterpret_cast< PyQPropertySet* >( arg );
+    if( !PyObject_TypeCheck( obj, &ps->type->pyQType.pyType ) ) {
+        RaisePyError( "Property set does not match object type", PyExc_TypeError );
+        return 0;
+    }
+    PyObject* seq = PySequence_Fast( values, "Sequence of values required" );
+    if( !seq ) return 0;
+    const int sz = ps->properties->size();
+    if( PySequence_Fast_GET_SIZE( seq ) != sz ) {
+        Py_DECREF( seq );
+        RaisePyError( qPrintable( QString( "%1 values required" ).arg( sz ) ), PyExc_ValueError );
+        return 0;
+    }
+    const int r = WriteProperties( pyqobj, *ps->properties, PySequence_Fast_ITEMS( seq ) );
+    Py_DECREF( seq );
+    if( r != 0 ) return 0;
+    Py_RETURN_NONE;
+}
+
+//----------------------------------------------------------------------------
+char PyContext::ArrayTypeCode( const Property& p ) {
+    switch( p.metaProperty_.userType() ) {
+    case QMetaType::Int: return 'i';
+    case QMetaType::Double: return 'd';
+    case QMetaType::Float: return 'f';
+    default: return 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+int PyContext::ArrayItemSize( char typeCode ) {
+    switch( typeCode ) {
+    case 'i': return sizeof( int );
+    case 'd': return sizeof( double );
+    case 'f': return sizeof( float );
+    default: return 0;
     }
 }
 
 //----------------------------------------------------------------------------
-int PyContext::PyQObjectSetter( PyQObject* qobj, PyObject* pv, void* closure ) {
-    const int id = int( reinterpret_cast< size_t >( closure ) );
-    if( id < qobj->type->methods.size() ) {
-        PyErr_SetString( PyExc_TypeError, "QPy methods are readonly!" );
+int PyContext::MetacallWriteProperty( QObject* obj, const Property& p, void* value ) {
+    // same argument layout as QMetaProperty::write: value, unused, status, flags;
+    // the write failed if no meta object handled the property or the handler
+    // set the status to zero
+    int status = -1;
+    int flags = 0;
+    void* argv[] = { value, 0, &status, &flags };
+    if( QMetaObject::metacall( obj, QMetaObject::WriteProperty, p.index_, argv ) >= 0
+        || status == 0 ) {
+        RaisePyError( qPrintable( "Cannot write property '" + QString( p.metaProperty_.name() ) + "'" ) );
         return -1;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+const PyContext::Property* PyContext::GatherProperty( PyObject* obj, PyObject* name,
+                                                      Type*& type, const Property*& p ) {
+    if( !IsQObject( obj ) ) {
+        RaisePyError( "Not a PyQObject", PyExc_TypeError );
+        return 0;
+    }
+    PyQObject* pyqobj = reinterpret_cast< PyQObject* >( obj );
+    if( !pyqobj->obj ) {
+        RaisePyError( "QObject has been destroyed" );
+        return 0;
+    }
+    // objects in a sequence are usually of the same type: resolve property
+    // only when the type changes
+    if( pyqobj->type != type ) {
+        const Property* np = FindProperty( *pyqobj->type, name );
+        if( !np ) return 0;
+        if( p && ArrayTypeCode( *np ) != ArrayTypeCode( *p ) ) {
+            RaisePyError( "Property type differs among objects", PyExc_TypeError );
+            return 0;
+        }
+        type = pyqobj->type;
+        p = np;
+    }
+    return p;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectGather( PyObject* self, PyObject* args ) {
+    PyObject* objects = 0;
+    PyObject* name = 0;
+    if( !PyArg_ParseTuple( args, "OS", &objects, &name ) ) return 0;
+    PyObject* seq = PySequence_Fast( objects, "Sequence of PyQObjects required" );
+    if( !seq ) return 0;
+    const int sz = int( PySequence_Fast_GET_SIZE( seq ) );
+    if( sz == 0 ) {
+        Py_DECREF( seq );
+        return PyList_New( 0 );
+    }
+    PyObject** items = PySequence_Fast_ITEMS( seq );
+    Type* type = 0;
+    const Property* p = 0;
+    if( !GatherProperty( items[ 0 ], name, type, p ) ) {
+        Py_DECREF( seq );
+        return 0;
+    }
+    PyObject* ret = 0;
+    const char typeCode = ArrayTypeCode( *p );
+    if( typeCode ) {
+        // numeric property: read values directly into the array data 
+        const int itemSize = ArrayItemSize( typeCode );
+        void* data = 0;
+        ret = NewNumericArray( typeCode, sz, &data );
+        char* buf = reinterpret_cast< char* >( data );
+        for( int i = 0; ret && i != sz; ++i ) {
+            if( !GatherProperty( items[ i ], name, type, p ) ) {
+                Py_CLEAR( ret );
+                break;
+            }
+            // property is resolved again when the type changes
+            if( !p->metaProperty_.isReadable() ) {
+                RaisePyError( qPrintable( "Cannot read property '"
+                                          + QString( p->metaProperty_.name() ) + "'" ) );
+                Py_CLEAR( ret );
+                break;
+            }
+            int status = -1;
+            void* argv[] = { buf + i * itemSize, 0, &status };
+            QMetaObject::metacall( reinterpret_cast< PyQObject* >( items[ i ] )->obj,
+                                   QMetaObject::ReadProperty, p->index_, argv );
+        }
     } else {
-        QMetaProperty p = qobj->obj->metaObject()->property( id - qobj->type->methods.size() );
-        if( !p.isWritable() ) {
-            RaisePyError( qPrintable( "Cannot write property '" + QString( p.name() ) + "'" ) );
+        ret = PyList_New( sz );
+        for( int i = 0; ret && i != sz; ++i ) {
+            PyObject* v = GatherProperty( items[ i ], name, type, p )
+                          ? ReadProperty( reinterpret_cast< PyQObject* >( items[ i ] ), *p ) : 0;
+            if( !v ) {
+                Py_CLEAR( ret );
+                break;
+            }
+            PyList_SET_ITEM( ret, i, v );
+        }
+    }
+    Py_DECREF( seq );
+    return ret;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectScatter( PyObject* self, PyObject* args ) {
+    PyObject* objects = 0;
+    PyObject* name = 0;
+    PyObject* values = 0;
+    if( !PyArg_ParseTuple( args, "OSO", &objects, &name, &values ) ) return 0;
+    PyObject* seq = PySequence_Fast( objects, "Sequence of PyQObjects required" );
+    if( !seq ) return 0;
+    const int sz = int( PySequence_Fast_GET_SIZE( seq ) );
+    PyObject** items = PySequence_Fast_ITEMS( seq );
+    Type* type = 0;
+    const Property* p = 0;
+    if( sz == 0 || !GatherProperty( items[ 0 ], name, type, p ) ) {
+        Py_DECREF( seq );
+        if( sz == 0 ) Py_RETURN_NONE;
+        return 0;
+    }
+    if( !p->metaProperty_.isWritable() ) {
+        Py_DECREF( seq );
+        RaisePyError( qPrintable( "Cannot write property '" + QString( p->metaProperty_.name() ) + "'" ) );
+        return 0;
+    }
+    // array with matching type: write values directly from the array data
+    const char typeCode = ArrayTypeCode( *p );
+    const void* buf = 0;
+    Py_ssize_t len = 0;
+    if( typeCode && PyObject_CheckReadBuffer( values ) ) {
+        PyObject* tc = PyObject_GetAttrString( values, "typecode" );
+        if( tc && PyString_Check( tc ) && PyString_GET_SIZE( tc ) == 1
+            && PyString_AS_STRING( tc )[ 0 ] == typeCode ) {
+            if( PyObject_AsReadBuffer( values, &buf, &len ) != 0 ) buf = 0;
+        }
+        Py_XDECREF( tc );
+        PyErr_Clear();
+    }
+    const int itemSize = ArrayItemSize( typeCode );
+    if( buf ) {
+        if( len != sz * itemSize ) {
+            Py_DECREF( seq );
+            RaisePyError( qPrintable( QString( "%1 values required" ).arg( sz ) ), PyExc_ValueError );
+            return 0;
+        }
+        int r = 0;
+        const Property* checked = p;
+        for( int i = 0; r == 0 && i != sz; ++i ) {
+            if( !GatherProperty( items[ i ], name, type, p ) ) {
+                r = -1;
+                break;
+            }
+            // property is resolved again when the type changes
+            if( p != checked && !p->metaProperty_.isWritable() ) {
+                RaisePyError( qPrintable( "Cannot write property '"
+                                          + QString( p->metaProperty_.name() ) + "'" ) );
+                r = -1;
+                break;
+            }
+            checked = p;
+            r = MetacallWriteProperty( reinterpret_cast< PyQObject* >( items[ i ] )->obj, *p,
+                                       const_cast< char* >( reinterpret_cast< const char* >( buf ) )
+                                       + i * itemSize );
+        }
+        Py_DECREF( seq );
+        if( r != 0 ) return 0;
+        Py_RETURN_NONE;
+    }
+    PyObject* vseq = PySequence_Fast( values, "Sequence of values required" );
+    if( !vseq ) {
+        Py_DECREF( seq );
+        return 0;
+    }
+    int r = 0;
+    if( PySequence_Fast_GET_SIZE( vseq ) != sz ) {
+        RaisePyError( qPrintable( QString( "%1 values required" ).arg( sz ) ), PyExc_ValueError );
+        r = -1;
+    }
+    for( int i = 0; r == 0 && i != sz; ++i ) {
+        r = GatherProperty( items[ i ], name, type, p ) 
+            ? WriteProperty( reinterpret_cast< PyQObject* >( items[ i ] ), *p, 
+                             PySequence_Fast_GET_ITEM( vseq, i ) ) : -1;
+    }
+    Py_DECREF( vseq );
+    Py_DECREF( seq );
+    if( r != 0 ) return 0;
+    Py_RETURN_NONE;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectInvokeMany( PyObject* self, PyObject* args ) {
+    PyObject* first = 0;
+    PyObject* second = 0;
+    PyObject* methodArgs = 0;
+    if( !PyArg_ParseTuple( args, "OO|O!", &first, &second, &PyTuple_Type, &methodArgs ) ) return 0;
+    const bool boundMethod = PyObject_TypeCheck( first, &pyQMethodType_ );
+    if( boundMethod && methodArgs ) {
+        RaisePyError( "2 arguments required with bound method", PyExc_TypeError );
+        return 0;
+    }
+    if( !boundMethod && !PyString_Check( second ) ) {
+        RaisePyError( "Bound method or sequence of PyQObjects and method name required",
+                      PyExc_TypeError );
+        return 0;
+    }
+    // bound method: one invocation per argument tuple;
+    // objects and method name: one invocation per object
+    PyObject* seq = PySequence_Fast( boundMethod ? second : first, "Sequence required" );
+    if( !seq ) return 0;
+    const int sz = int( PySequence_Fast_GET_SIZE( seq ) );
+    PyObject** items = PySequence_Fast_ITEMS( seq );
+    PyObject* emptyArgs = methodArgs ? methodArgs : PyTuple_New( 0 );
+    if( !emptyArgs ) {
+        Py_DECREF( seq );
+        return 0;
+    }
+    PyObject* ret = PyList_New( sz );
+    PyQObject* obj = boundMethod ? reinterpret_cast< PyQMethod* >( first )->self : 0;
+    const Overloads* overloads = boundMethod ? reinterpret_cast< PyQMethod* >( first )->overloads : 0;
+    Type* type = 0;
+    // one frame for all invocations: memory is allocated only if a method
+    // requires more storage than the previous ones
+    CallFrame frame( 0, 0 );
+    for( int i = 0; ret && i != sz; ++i ) {
+        PyObject* a = emptyArgs;
+        if( boundMethod ) {
+            a = items[ i ];
+            if( !PyTuple_Check( a ) ) {
+                RaisePyError( "Tuple of arguments required", PyExc_TypeError );
+                Py_CLEAR( ret );
+                break;
+            }
+        } else {
+            if( !IsQObject( items[ i ] ) ) {
+                RaisePyError( "Not a PyQObject", PyExc_TypeError );
+                Py_CLEAR( ret );
+                break;
+            }
+            obj = reinterpret_cast< PyQObject* >( items[ i ] );
+            // resolve method name only when the type changes
+            if( obj->type != type ) {
+                PyObject* m = PyObject_GetAttr( items[ i ], second );
+                if( !m || !PyObject_TypeCheck( m, &pyQMethodType_ ) ) {
+                    if( m ) RaisePyError( "Not a PyQObject method", PyExc_TypeError );
+                    Py_XDECREF( m );
+                    Py_CLEAR( ret );
+                    break;
+                }
+                overloads = reinterpret_cast< PyQMethod* >( m )->overloads;
+                type = obj->type;
+                Py_DECREF( m );
+            }
+        }
+        const Method* m = overloads->Resolve( a );
+        PyObject* r = 0;
+        if( m ) {
+            frame.Reset( m->arity_, m->storageSize_ );
+            r = InvokeMethod( obj, *m, a, frame );
+        }
+        if( !r ) {
+            Py_CLEAR( ret );
+            break;
+        }
+        PyList_SET_ITEM( ret, i, r );
+    }
+    if( !methodArgs ) Py_DECREF( emptyArgs );
+    Py_DECREF( seq );
+    return ret;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectConstructMany( PyObject* self, PyObject* args ) {
+    PyTypeObject* type = 0;
+    PyObject* ctorArgs = 0;
+    if( !PyArg_ParseTuple( args, "O!O", &PyType_Type, &type, &ctorArgs ) ) return 0;
+    if( !PyType_IsSubtype( type, &pyQObjectType_ ) || type == &pyQObjectType_ ) {
+        RaisePyError( "Not a PyQObject type", PyExc_TypeError );
+        return 0;
+    }
+    // number of objects or sequence of argument tuples
+    PyObject* seq = 0;
+    int sz = 0;
+    if( PyInt_Check( ctorArgs ) || PyLong_Check( ctorArgs ) ) {
+        const Py_ssize_t n = PyNumber_AsSsize_t( ctorArgs, PyExc_OverflowError );
+        if( n == -1 && PyErr_Occurred() ) return 0;
+        if( n < 0 ) {
+            RaisePyError( "Negative number of objects", PyExc_ValueError );
+            return 0;
+        }
+        if( n > INT_MAX ) {
+            RaisePyError( "Too many objects", PyExc_OverflowError );
+            return 0;
+        }
+        sz = int( n );
+    } else {
+        seq = PySequence_Fast( ctorArgs, "Number of objects or sequence of tuples required" );
+        if( !seq ) return 0;
+        sz = int( PySequence_Fast_GET_SIZE( seq ) );
+    }
+    PyObject* emptyArgs = PyTuple_New( 0 );
+    if( !emptyArgs ) {
+        Py_XDECREF( seq );
+        return 0;
+    }
+    PyObject* ret = PyList_New( sz );
+    // derived Python types might define their own __init__: construct through type call
+    const bool qpyType = type->tp_base == &pyQObjectType_;
+    Type* t = qpyType ? reinterpret_cast< PyQType* >( type )->type : 0;
+    CallFrame frame( 0, 0 );
+    // argument tuples usually have the same types: the constructor is resolved
+    // again only when the number of arguments or the type match reported by the
+    // previously selected constructor changes
+    const Method* ctor = 0;
+    QVarLengthArray< int, MAX_GENERIC_ARGS > checks;
+    for( int i = 0; ret && i != sz; ++i ) {
+        PyObject* a = seq ? PySequence_Fast_GET_ITEM( seq, i ) : emptyArgs;
+        if( !PyTuple_Check( a ) ) {
+            RaisePyError( "Tuple of arguments required", PyExc_TypeError );
+            Py_CLEAR( ret );
+            break;
+        }
+        PyObject* obj = 0;
+        if( qpyType ) {
+            const int arity = int( PyTuple_GET_SIZE( a ) );
+            bool resolve = !ctor || ctor->arity_ != arity;
+            for( int j = 0; !resolve && j != arity; ++j ) {
+                resolve = ctor->argumentWrappers_[ j ].Check( PyTuple_GET_ITEM( a, j ) ) != checks[ j ];
+            }
+            if( resolve ) {
+                ctor = t->ctorOverloads.Resolve( a );
+                checks.resize( ctor ? arity : 0 );
+                for( int j = 0; j != checks.size(); ++j ) {
+                    checks[ j ] = ctor->argumentWrappers_[ j ].Check( PyTuple_GET_ITEM( a, j ) );
+                }
+            }
+            obj = ctor ? PyQObjectNew( type, 0, 0 ) : 0;
+            if( obj ) {
+                frame.Reset( ctor->arity_, ctor->storageSize_ );
+                if( ConstructQObject( reinterpret_cast< PyQObject* >( obj ), *ctor, a, frame ) != 0 ) {
+                    Py_CLEAR( obj );
+                }
+            }
+        } else {
+            obj = PyObject_Call( reinterpret_cast< PyObject* >( type ), a, 0 );
+        }
+        if( !obj ) {
+            Py_CLEAR( ret );
+            break;
+        }
+        PyList_SET_ITEM( ret, i, obj );
+    }
+    Py_XDECREF( emptyArgs );
+    Py_XDECREF( seq );
+    return ret;
+}
+
+//----------------------------------------------------------------------------
+void PyContext::PyQPropertySetDealloc( PyQPropertySet* self ) {
+    delete self->properties;
+    Py_XDECREF( self->names );
+    PyObject_Del( self );
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectMethodGetter( PyQObject* qobj, void* closure /*Overloads*/ ) {
+    PyQMethod* m = PyObject_New( PyQMethod, &pyQMethodType_ );
+    if( !m ) return 0;
+    Py_INCREF( qobj );
+    m->self = qobj;
+    m->overloads = reinterpret_cast< const Overloads* >( closure );
+    return reinterpret_cast< PyObject* >( m );
+}
+
+//----------------------------------------------------------------------------
+int PyContext::PyQObjectMethodSetter( PyQObject*, PyObject*, void* ) {
+    PyErr_SetString( PyExc_TypeError, "QPy methods are readonly!" );
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectPropertyGetter( PyQObject* qobj, void* closure /*Property*/ ) {
+    return ReadProperty( qobj, *reinterpret_cast< const Property* >( closure ) );
+}
+
+//----------------------------------------------------------------------------
+int PyContext::PyQObjectPropertySetter( PyQObject* qobj, PyObject* pv, void* closure /*Property*/ ) {
+    return WriteProperty( qobj, *reinterpret_cast< const Property* >( closure ), pv );
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::ReadProperty( PyQObject* qobj, const Property& p ) {
+    if( !qobj->obj ) {
+        RaisePyError( "QObject has been destroyed" );
+        return 0;
+    }
+    if( !p.metaProperty_.isReadable() ) {
+        RaisePyError( qPrintable( "Cannot read property '" + QString( p.metaProperty_.name() ) + "'" ) );
+        return 0;
+    }
+    if( p.typedRead_ ) {
+        try {
+            // same argument layout as QMetaProperty::read: value, unused, status
+            CallFrame frame( 0, CallFrame::AlignedSize( p.reader_.StorageSize() ) );
+            void* value = frame.SetReturn( p.reader_ );
+            int status = -1;
+            void* argv[] = { value, 0, &status };
+            QMetaObject::metacall( qobj->obj, QMetaObject::ReadProperty, p.index_, argv );
+            if( p.reader_.IsQObjectPtr() ) {
+                // returned objects are not owned by Python
+                return qobj->type->pyContext->AddObject( *reinterpret_cast< QObject** >( value ),
+                                                         qobj->type->pyModule,
+                                                         qobj->type->pyModule,
+                                                         0 );
+            }
+            return p.reader_.Create( value );
+        } catch( const std::exception& e ) {
+            RaisePyError( e.what() );
+            return 0;
+        }
+    }
+    PyContext* pc = qobj->type->pyContext;
+    // user types are identified by userType(), type() returns QVariant::UserType
+    const QVariantToPyObject* c = pc->FindQVariantToPyObject( p.metaProperty_.userType() );
+    if( !c ) {
+        RaisePyError( qPrintable( "Type " + QString( p.metaProperty_.typeName() ) + " not supported" ) );
+        return 0;
+    }
+    return c->Create( p.metaProperty_.read( qobj->obj ) );
+}
+
+//----------------------------------------------------------------------------
+int PyContext::WriteProperty( PyQObject* qobj, const Property& p, PyObject* pv ) {
+    if( !qobj->obj ) {
+        RaisePyError( "QObject has been destroyed" );
+        return -1;
+    }
+    if( !pv ) {
+        RaisePyError( qPrintable( "Cannot delete property '" + QString( p.metaProperty_.name() ) + "'" ) );
+        return -1;
+    }
+    if( !p.metaProperty_.isWritable() ) {
+        RaisePyError( qPrintable( "Cannot write property '" + QString( p.metaProperty_.name() ) + "'" ) );
+        return -1;
+    }
+    if( p.typedWrite_ ) {
+        try {
+            CallFrame frame( 1, CallFrame::AlignedSize( p.writer_.StorageSize() ) );
+            if( !frame.PushArg( p.writer_, pv ) ) return -1;
+            return MetacallWriteProperty( qobj->obj, p, frame.Arg( 0 ) );
+        } catch( const std::exception& e ) {
+            RaisePyError( e.what() );
+            return -1;
+        }
+    }
+    PyContext* pc = qobj->type->pyContext;
+    const PyObjectToQVariant* c = pc->FindPyObjectToQVariant( p.metaProperty_.userType() );
+    if( !c ) {
+        RaisePyError( qPrintable( "Type " + QString( p.metaProperty_.typeName() ) + " not supported" ) );
+        return -1;
+    }
+    const QVariant v = c->Create( pv );
+    if( PyErr_Occurred() ) return -1;
+    p.metaProperty_.write( qobj->obj, v );
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+int PyContext::WriteProperties( PyQObject* qobj, const QVector< const Property* >& props,
+                                PyObject* const* values ) {
+    if( !qobj->obj ) {
+        RaisePyError( "QObject has been destroyed" );
+        return -1;
+    }
+    // check and convert all the values before writing: a failed conversion
+    // leaves the object unchanged
+    PyContext* pc = qobj->type->pyContext;
+    const int sz = props.size();
+    int storageSize = 0;
+    int typed = 0;
+    QVector< const PyObjectToQVariant* > converters( sz );
+    for( int i = 0; i != sz; ++i ) {
+        const Property& p = *props[ i ];
+        if( !p.metaProperty_.isWritable() ) {
+            RaisePyError( qPrintable( "Cannot write property '" + QString( p.metaProperty_.name() ) + "'" ) );
             return -1;
         }
-        if( !qobj->type->pyContext->pyObjectToQVariant_.contains( p.type() ) ) {
-            RaisePyError( qPrintable( "Type " + QString( p.typeName() ) + " not supported" ) );
+        if( p.typedWrite_ ) {
+            storageSize += CallFrame::AlignedSize( p.writer_.StorageSize() );
+            ++typed;
+        } else if( !( converters[ i ] = pc->FindPyObjectToQVariant( p.metaProperty_.userType() ) ) ) {
+            RaisePyError( qPrintable( "Type " + QString( p.metaProperty_.typeName() ) + " not supported" ) );
             return -1;
         }
-        const QVariant v = qobj->type->pyContext->pyObjectToQVariant_[ p.type() ]->Create( pv );
-        p.write( qobj->obj, v );
+    }
+    try {
+        CallFrame frame( typed, storageSize );
+        QVector< QVariant > variants( sz );
+        for( int i = 0; i != sz; ++i ) {
+            if( props[ i ]->typedWrite_ ) {
+                if( !frame.PushArg( props[ i ]->writer_, values[ i ] ) ) return -1;
+            } else {
+                variants[ i ] = converters[ i ]->Create( values[ i ] );
+                if( PyErr_Occurred() ) return -1;
+            }
+        }
+        for( int i = 0, a = 0; i != sz; ++i ) {
+            // the object could be destroyed by a property writer
+            if( !qobj->obj ) {
+                RaisePyError( "QObject has been destroyed" );
+                return -1;
+            }
+            if( props[ i ]->typedWrite_ ) {
+                if( MetacallWriteProperty( qobj->obj, *props[ i ], frame.Arg( a++ ) ) != 0 ) return -1;
+            } else props[ i ]->metaProperty_.write( qobj->obj, variants[ i ] );
+        }
         return 0;
+    } catch( const std::exception& e ) {
+        RaisePyError( e.what() );
+        return -1;
+    }
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQObjectGetAttr( PyObject* self, PyObject* name ) {
+    PyObject* attr = PyObject_GenericGetAttr( self, name );
+    if( attr || !PyErr_ExceptionMatches( PyExc_AttributeError ) ) return attr;
+    // not found: add member to type if available and retry
+    Type* type = reinterpret_cast< PyQObject* >( self )->type;
+    if( !PyString_Check( name ) 
+        || !type->lazyMembers.contains( PyString_AS_STRING( name ) ) ) return 0;
+    PyErr_Clear();
+    try {
+        if( !type->pyContext->MaterializeMember( *type, PyString_AS_STRING( name ) ) ) return 0;
+    } catch( const std::exception& e ) {
+        RaisePyError( e.what() );
+        return 0;
+    }
+    return PyObject_GenericGetAttr( self, name );
+}
+
+//----------------------------------------------------------------------------
+int PyContext::PyQObjectSetAttr( PyObject* self, PyObject* name, PyObject* value ) {
+    // add member first: instances of derived Python types have a dictionary
+    // where a value would otherwise be stored, hiding the property
+    Type* type = reinterpret_cast< PyQObject* >( self )->type;
+    if( PyString_Check( name ) && type->lazyMembers.contains( PyString_AS_STRING( name ) ) ) {
+        try {
+            if( !type->pyContext->MaterializeMember( *type, PyString_AS_STRING( name ) ) ) return -1;
+        } catch( const std::exception& e ) {
+            RaisePyError( e.what() );
+            return -1;
+        }
     }
+    return PyObject_GenericSetAttr( self, name, value );
 }
 
 //----------------------------------------------------------------------------
 PyObject* PyContext::PyQObjectNew( PyTypeObject* type, PyObject*, PyObject* ) {
-    PyQObject* self = reinterpret_cast< PyQObject* >( type->tp_alloc( type, 0 ) );
-    if( !self ) return 0;
+    PyQObject* self = 0;
+    if( freeList_ && type->tp_base == &pyQObjectType_ ) {
+        // instances of QPy types all have the same size: any free wrapper
+        // can be reused, the next free wrapper is stored into 'obj'
+        self = freeList_;
+        freeList_ = reinterpret_cast< PyQObject* >( self->obj );
+        --numFree_;
+        PyObject_INIT( self, type );
+    } else {
+        self = reinterpret_cast< PyQObject* >( type->tp_alloc( type, 0 ) );
+        if( !self ) return 0;
+    }
     self->obj = 0;
     self->foreignOwned = false;
-    self->pyModule = 0;
     //find base type: for object derived from PyQObjects we need to find the
     //base PyQObject base to initialize the type pointer; the base class is the
-    //first child of the base Python 'object' class, which in turn has a NULL parent
+    //first child of the QPy root type
     PyTypeObject* p = type;
-    while( p->tp_base && p->tp_base->tp_base ) p = p->tp_base;
-    self->type = reinterpret_cast< Type* >(
-        PyCapsule_GetPointer( PyDict_GetItemString( p->tp_dict, "__qpy_type_info__" ),
-                                  "qpy type info" ) );
+    while( p->tp_base != &pyQObjectType_ ) p = p->tp_base;
+    self->type = reinterpret_cast< PyQType* >( p )->type;
     return reinterpret_cast< PyObject* >( self );
 }
 
 //----------------------------------------------------------------------------
-PyObject* PyContext::PyQObjectInvokeMethod( PyQObject* self, PyObject* args ) {
-    signal_ = false;
-    endpoints_.clear(); // cheap, usually emtpy or with a single element, in case
-                        // a signal is invoke explicitly
-    std::vector< QGenericArgument > ga( MAX_GENERIC_ARGS );
+PyObject* PyContext::PyQObjectInvokeMethod( PyQObject* self, const Method& m, PyObject* args ) {
+    // converted values live in the frame: recursive invocations of the same
+    // method and invocations from different threads do not share storage
+    CallFrame frame( m.arity_, m.storageSize_ );
+    return InvokeMethod( self, m, args, frame );
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::InvokeMethod( PyQObject* self, const Method& m, PyObject* args,
+                                   CallFrame& frame ) {
+    if( !self->obj ) {
+        RaisePyError( "QObject has been destroyed" );
+        return 0;
+    }
     const int sz = int( PyTuple_Size( args ) );
-    const Method& m = self->type->methods[ getterMethodId_ ];
-    if( sz > m.argumentWrappers_.size() ) {
+    if( sz > m.arity_ ) {
         RaisePyError( qPrintable(QString( "Method %1::%2 requires %3 arguments, %4 provided" )
                       .arg( m.metaObject_->className() )
                       .arg( m.metaMethod_.signature() )
-                      .arg( m.argumentWrappers_.size() )
+                      .arg( m.arity_ )
                       .arg( sz ) ) );
         return 0;
     }
-    for( int i = 0; i != sz; ++i ) {
-        PyObject* obj = PyTuple_GetItem( args, i );
-        ga[ i ] = m.argumentWrappers_[ i ].Arg( obj );
-    }
-    try {     
-        if( m.returnWrapper_.MetaType() == QMetaType::Void ) {
-            m.metaMethod_.invoke( self->obj, Qt::AutoConnection, ga[ 0 ], ga[ 1 ], ga[ 2 ], ga[ 3 ],
-                      ga[ 4 ], ga[ 5 ], ga[ 6 ], ga[ 7 ], ga[ 8 ], ga[ 9 ] );
-            Py_INCREF(Py_None);
-            return Py_None;
-        } else {  
-            if( m.returnWrapper_.IsQObjectPtr() ) {
-                QObject* ptr = 0;
-                m.metaMethod_.invoke( self->obj, Qt::AutoConnection, Q_RETURN_ARG( QObject*, ptr ),
-                      ga[ 0 ], ga[ 1 ], ga[ 2 ], ga[ 3 ],
-                      ga[ 4 ], ga[ 5 ], ga[ 6 ], ga[ 7 ], ga[ 8 ], ga[ 9 ] );
-                PyQObject* obj = reinterpret_cast< PyQObject* > (
-                                     PyObject_CallObject( reinterpret_cast< PyObject* >( &(self->type->pyType) ), 0 ) );
-                obj->foreignOwned = false;
-                obj->obj = ptr;
-                return reinterpret_cast< PyObject* >( obj );
+    try {
+        for( int i = 0; i != sz; ++i ) {
+            if( !frame.PushArg( m.argumentWrappers_[ i ], PyTuple_GET_ITEM( args, i ) ) ) return 0;
+        }
+        void* ret = frame.SetReturn( m.returnWrapper_ );
+        if( sz == m.arity_ && self->obj->thread() == QThread::currentThread() ) {
+            // same thread and all arguments available: call qt_metacall directly
+            // with the method index computed at type creation time; this skips
+            // the signature validation and connection type resolution performed
+            // by QMetaMethod::invoke
+            QMetaObject::metacall( self->obj, QMetaObject::InvokeMetaMethod, m.index_, frame.Argv() );
+        } else if( sz > MAX_GENERIC_ARGS ) {
+            RaisePyError( qPrintable( QString( "Method %1::%2: cannot queue calls with more than %3 arguments" )
+                          .arg( m.metaObject_->className() )
+                          .arg( m.metaMethod_.signature() )
+                          .arg( MAX_GENERIC_ARGS ) ) );
+            return 0;
+        } else {
+            // queued call or default arguments: let Qt resolve the method;
+            // unused arguments are default constructed i.e. invalid
+            GenericArguments ga( MAX_GENERIC_ARGS );
+            for( int i = 0; i != sz; ++i ) {
+                ga[ i ] = QGenericArgument( m.argumentTypes_[ i ].constData(), frame.Arg( i ) );
+            }
+            bool invoked = false;
+            if( !ret ) {
+                invoked = m.metaMethod_.invoke( self->obj, Qt::AutoConnection,
+                          ga[ 0 ], ga[ 1 ], ga[ 2 ], ga[ 3 ],
+                          ga[ 4 ], ga[ 5 ], ga[ 6 ], ga[ 7 ], ga[ 8 ], ga[ 9 ] );
             } else {
-                 m.metaMethod_.invoke( self->obj, Qt::AutoConnection, m.returnWrapper_.Arg(),
-                      ga[ 0 ], ga[ 1 ], ga[ 2 ], ga[ 3 ],
-                      ga[ 4 ], ga[ 5 ], ga[ 6 ], ga[ 7 ], ga[ 8 ], ga[ 9 ] );
-                return m.returnWrapper_.Create();                     
+                // fails for queued calls: return values are not available
+                invoked = m.metaMethod_.invoke( self->obj, Qt::AutoConnection,
+                          QGenericReturnArgument( m.metaMethod_.typeName(), ret ),
+                          ga[ 0 ], ga[ 1 ], ga[ 2 ], ga[ 3 ],
+                          ga[ 4 ], ga[ 5 ], ga[ 6 ], ga[ 7 ], ga[ 8 ], ga[ 9 ] );
+            }
+            if( !invoked ) {
+                RaisePyError( qPrintable( QString( "Method %1::%2 cannot be invoked" )
+                              .arg( m.metaObject_->className() )
+                              .arg( m.metaMethod_.signature() ) ) );
+                return 0;
             }
         }
+        if( !ret ) {
+            Py_RETURN_NONE;
+        } else if( m.returnWrapper_.IsQObjectPtr() ) {
+            // returned objects are not owned by Python
+            return self->type->pyContext->AddObject( *reinterpret_cast< QObject** >( ret ),
+                                                     self->type->pyModule,
+                                                     self->type->pyModule,
+                                                     0 );
+        } else {
+            return m.returnWrapper_.Create( ret );
+        }
     } catch( const std::exception& e ) {
         RaisePyError( e.what() );
         return 0;        
@@ -574,45 +1723,45 @@ PyObject* PyContext::PyQObjectInvokeMethod( PyQObject* self, PyObject* args ) {
 //----------------------------------------------------------------------------
 int PyContext::PyQObjectInit( PyQObject* self, PyObject* args, PyObject* kwds ) {
     if( !self->foreignOwned ) {
-        std::vector< QGenericArgument > ga( MAX_GENERIC_ARGS );
-        const int sz = int( PyTuple_Size( args ) );
-        const QArgWrappers* pArgWrappers = 0;
-        for( int i = 0; i != self->type->ctorParams.size(); ++i ) {
-            if( self->type->ctorParams[ i ].size() == sz ) {
-                pArgWrappers = &self->type->ctorParams[ i ];
-                break;
-            }
-        }
-        if( !pArgWrappers ) {
-            RaisePyError( "Cannot find constructor" );
-            return -1;
-        }
-        const QArgWrappers& argWrappers = *pArgWrappers;
-        /// @todo implement overloading based on the number of arguments
-        for( int i = 0; i != sz; ++i ) {
-             PyObject* obj = PyTuple_GetItem( args, i );
-            ///@todo
-            /// if( !self->ctorParams[ i ].CheckType( obj ) ) {
-            ///     PyErr_SetString( PyExc_TypeError, "QPy: Wrong type passed to constructor" );
-            ///     return -1;   
-            /// }
-            ga[ i ] = argWrappers[ i ].Arg( reinterpret_cast< PyObject* >( obj ) );
-        }
-        self->obj = self->type->metaObject->newInstance( ga[ 0 ], ga[ 1 ], ga[ 2 ], ga[ 3 ],
-                                                         ga[ 4 ], ga[ 5 ], ga[ 6 ], ga[ 7 ],
-                                                         ga[ 8 ], ga[ 9 ] );
-    }
-
-    static PyMethodDef md;
-    md.ml_name = "__qpy_invoke_method";
-    md.ml_meth = reinterpret_cast< PyCFunction >( PyQObjectInvokeMethod );
-    md.ml_flags = METH_VARARGS;
-    md.ml_doc = "Invoke QObject method";
-    self->invoke = PyCFunction_NewEx( &md, reinterpret_cast< PyObject* >( self ),
-                                      PyString_FromString( md.ml_name ) );   
+        const Method* ctor = self->type->ctorOverloads.Resolve( args );
+        if( !ctor ) return -1;
+        CallFrame frame( ctor->arity_, ctor->storageSize_ );
+        return ConstructQObject( self, *ctor, args, frame );
+    }
     return 0;
 }
 
+//----------------------------------------------------------------------------
+int PyContext::ConstructQObject( PyQObject* self, const Method& ctor, PyObject* args,
+                                 CallFrame& frame ) {
+    // same layout as QMetaObject::newInstance, without the limit on the
+    // number of arguments: first element is the address of the returned
+    // QObject pointer
+    QObject* obj = 0;
+    for( int i = 0; i != ctor.arity_; ++i ) {
+        if( !frame.PushArg( ctor.argumentWrappers_[ i ], PyTuple_GET_ITEM( args, i ) ) ) return -1;
+    }
+    frame.Argv()[ 0 ] = &obj;
+    self->type->metaObject->static_metacall( QMetaObject::CreateInstance, ctor.index_, frame.Argv() );
+    if( self->obj ) self->type->pyContext->wrapperCache_.Remove( self );
+    self->obj = obj;
+    if( obj ) self->type->pyContext->wrapperCache_.Insert( self );
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+PyObject* PyContext::PyQMethodCall( PyQMethod* self, PyObject* args, PyObject* ) {
+    const Method* m = self->overloads->Resolve( args );
+    if( !m ) return 0;
+    return PyQObjectInvokeMethod( self->self, *m, args );
+}
+
+//----------------------------------------------------------------------------
+void PyContext::PyQMethodDealloc( PyQMethod* self ) {
+    Py_XDECREF( self->self );
+    PyObject_Del( self );
+}
+
 //----------------------------------------------------------------------------
 PyObject* PyContext::PyQObjectTr( PyObject* self, PyObject* args ) {
     const char* s = 0;
@@ -625,19 +1774,37 @@ PyObject* PyContext::PyQObjectTr( PyObject* self, PyObject* args ) {
 
 //----------------------------------------------------------------------------
 void PyContext::PyQObjectDealloc( PyQObject* self ) {
+    if( self->obj ) self->type->pyContext->wrapperCache_.Remove( self );
     if( !self->foreignOwned && self->obj ) {
         self->obj->deleteLater();
         self->obj = 0;
     }
-    Py_XDECREF( self->invoke );
-    self->ob_type->tp_free( reinterpret_cast< PyObject* >( self ) );
+    // instances of derived Python types have a different layout; wrappers
+    // deallocated while the interpreter is being finalized are not reused
+    if( self->ob_type->tp_base == &pyQObjectType_ && numFree_ < MAX_FREE_WRAPPERS
+        && Py_IsInitialized() ) {
+        self->obj = reinterpret_cast< QObject* >( freeList_ );
+        freeList_ = self;
+        ++numFree_;
+    } else {
+        self->ob_type->tp_free( reinterpret_cast< PyObject* >( self ) );
+    }
+}
+
+//----------------------------------------------------------------------------
+int PyContext::ClearFreeList() {
+    const int n = numFree_;
+    while( freeList_ ) {
+        PyQObject* next = reinterpret_cast< PyQObject* >( freeList_->obj );
+        PyObject_Del( freeList_ );
+        freeList_ = next;
+    }
+    numFree_ = 0;
+    return n;
 }
 
 //----------------------------------------------------------------------------
 PyTypeObject PyContext::CreatePyType( const Type& type ) {
-    static PyMemberDef members[] = { { const_cast< char* >( "__qpy_qobject_tag__" ), T_BOOL, 
-                           offsetof( PyQObject, qobjectTag ), 0, const_cast< char* >( "Identifies object as QPy QObject wrapper" ) },
-                           { 0, 0, 0, 0, 0 } };                
     PyTypeObject t = {
         PyObject_HEAD_INIT(NULL)
         0,                         /*ob_size*/
@@ -668,9 +1835,9 @@ PyTypeObject PyContext::CreatePyType( const Type& type ) {
         0,                     /* tp_iter */
         0,                     /* tp_iternext */
         0,             /* tp_methods */
-        members,             /* tp_members */
+        0,             /* tp_members */
         const_cast< PyGetSetDef* >( &type.pyMembers[ 0 ] ),                         /* tp_getset */
-        0,                         /* tp_base */
+        &pyQObjectType_,           /* tp_base */
         0,                         /* tp_dict */
         0,                         /* tp_descr_get */
         0,                         /* tp_descr_set */
@@ -28,9 +28,78 @@
 
 namespace qpy {
 
-QGenericArgument ObjectStarQArgConstructor::Create( PyObject* pyobj ) const {
-    obj_ = reinterpret_cast< PyContext::PyQObject* >( pyobj )->obj;
-    return Q_ARG( QObject*, obj_ );
+void* ObjectStarQArgConstructor::Construct( PyObject* pyobj, void* storage ) const {
+    if( pyobj == Py_None ) return new ( storage ) QObject*( 0 );
+    if( !PyContext::IsQObject( pyobj ) ) {
+        RaisePyError( "Not a PyQObject", PyExc_TypeError );
+        return 0;
+    }
+    return new ( storage ) QObject*( reinterpret_cast< PyContext::PyQObject* >( pyobj )->obj );
 }    	
+
+int ObjectStarQArgConstructor::Check( PyObject* pyobj ) const {
+    if( PyContext::IsQObject( pyobj ) ) return 2;
+    return pyobj == Py_None ? 1 : 0;
+}
+
+void* TypedObjectStarQArgConstructor::Construct( PyObject* pyobj, void* storage ) const {
+    if( pyobj == Py_None ) return new ( storage ) QObject*( 0 );
+    if( !PyContext::IsQObject( pyobj ) ) {
+        RaisePyError( "Not a PyQObject", PyExc_TypeError );
+        return 0;
+    }
+    if( !Derived( pyobj ) ) {
+        RaisePyError( ( QByteArray( reinterpret_cast< PyContext::PyQObject* >( pyobj )
+                                        ->type->metaObject->className() )
+                        + " is not a " + className_ ).constData(), PyExc_TypeError );
+        return 0;
+    }
+    return new ( storage ) QObject*( reinterpret_cast< PyContext::PyQObject* >( pyobj )->obj );
+}
+
+int TypedObjectStarQArgConstructor::Check( PyObject* pyobj ) const {
+    if( PyContext::IsQObject( pyobj ) ) return Derived( pyobj ) ? 2 : 0;
+    return pyobj == Py_None ? 1 : 0;
+}
+
+bool TypedObjectStarQArgConstructor::Derived( PyObject* pyobj ) const {
+    const QMetaObject* m = reinterpret_cast< PyContext::PyQObject* >( pyobj )->type->metaObject;
+    if( mo_ ) {
+        for( ; m && m != mo_; m = m->superClass() );
+        return m != 0;
+    }
+    for( ; m && className_ != m->className(); m = m->superClass() );
+    mo_ = m;
+    return m != 0;
+}
+
+PyObject* TypedObjectStarPyArgConstructor::Create( void* p ) const {
+    if( !*reinterpret_cast< void** >( p ) ) Py_RETURN_NONE;
+    RaisePyError( ( "Type " + className_ + "* unknown" ).constData(), PyExc_TypeError );
+    return 0;
+}
+
+bool TypedObjectStarPyArgConstructor::IsQObjectPtr() const {
+    if( !qobject_ ) qobject_ = ctx_->IsQObjectClass( className_ );
+    return qobject_;
+}
+
+void* ByteArrayQArgConstructor::Construct( PyObject* pyobj, void* storage ) const {
+    if( const QByteArray* b = ByteArrayConverter::Get( pyobj ) ) {
+        // data already owned by a QByteArray: share it
+        return new ( storage ) QByteArray( *b );
+    }
+    Py_buffer view;
+    if( PyObject_GetBuffer( pyobj, &view, PyBUF_SIMPLE ) != 0 ) return 0;
+    QByteArray* a = new ( storage ) QByteArray( reinterpret_cast< const char* >( view.buf ),
+                                                int( view.len ) );
+    PyBuffer_Release( &view );
+    return a;
+}
+
+int ByteArrayQArgConstructor::Check( PyObject* pyobj ) const {
+    return ByteArrayConverter().Check( pyobj );
+}
+
 	
 }
@@ -0,0 +1,643 @@
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Python.h>
+#include <datetime.h>
+#include "../include/detail/PyDefaultConverters.h"
+#include "../include/detail/PyStringConversion.h"
+#include "../include/PyContext.h"
+
+namespace qpy {
+
+namespace {
+/// The datetime C API is imported on first use, when the interpreter is
+/// already initialized; the PyDateTimeAPI pointer is local to this file.
+bool ImportDateTime() {
+    if( !PyDateTimeAPI ) PyDateTime_IMPORT;
+    return PyDateTimeAPI != 0;
+}
+
+/// Python object holding a QByteArray, see ByteArrayConverter.
+struct PyQByteArray {
+    PyObject_HEAD
+    QByteArray array;
+};
+
+void PyQByteArrayDealloc( PyQByteArray* self ) {
+    self->array.~QByteArray();
+    PyObject_Del( self );
+}
+
+Py_ssize_t PyQByteArrayLength( PyQByteArray* self ) {
+    return self->array.size();
+}
+
+PyObject* PyQByteArrayStr( PyQByteArray* self ) {
+    return PyString_FromStringAndSize( self->array.constData(), self->array.size() );
+}
+
+/// Read-only buffer exporting the QByteArray data.
+int PyQByteArrayGetBuffer( PyQByteArray* self, Py_buffer* view, int flags ) {
+    return PyBuffer_FillInfo( view, reinterpret_cast< PyObject* >( self ),
+                              const_cast< char* >( self->array.constData() ),
+                              self->array.size(), 1, flags );
+}
+
+/// Old-style buffer interface, used by Python 2 functions such as @c file.write.
+Py_ssize_t PyQByteArrayGetReadBuffer( PyQByteArray* self, Py_ssize_t segment, void** p ) {
+    if( segment != 0 ) {
+        RaisePyError( "Accessing non-existent segment", PyExc_SystemError );
+        return -1;
+    }
+    *p = const_cast< char* >( self->array.constData() );
+    return self->array.size();
+}
+
+Py_ssize_t PyQByteArrayGetSegCount( PyQByteArray* self, Py_ssize_t* len ) {
+    if( len ) *len = self->array.size();
+    return 1;
+}
+
+PySequenceMethods pyQByteArraySequence = {
+    reinterpret_cast< lenfunc >( PyQByteArrayLength ), /*sq_length*/
+};
+
+PyBufferProcs pyQByteArrayBuffer = {
+    reinterpret_cast< readbufferproc >( PyQByteArrayGetReadBuffer ), /*bf_getreadbuffer*/
+    0,                                                                /*bf_getwritebuffer*/
+    reinterpret_cast< segcountproc >( PyQByteArrayGetSegCount ),     /*bf_getsegcount*/
+    reinterpret_cast< charbufferproc >( PyQByteArrayGetReadBuffer ), /*bf_getcharbuffer*/
+    reinterpret_cast< getbufferproc >( PyQByteArrayGetBuffer ),      /*bf_getbuffer*/
+    0                                                                 /*bf_releasebuffer*/
+};
+
+PyTypeObject pyQByteArrayType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.ByteArray",           /*tp_name*/
+    sizeof( PyQByteArray ),    /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( PyQByteArrayDealloc ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    &pyQByteArraySequence,     /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    reinterpret_cast< reprfunc >( PyQByteArrayStr ), /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    &pyQByteArrayBuffer,       /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER, /*tp_flags*/
+    "QByteArray data exported through the buffer protocol" /* tp_doc */
+};
+}
+
+//----------------------------------------------------------------------------
+bool ULongLongConverter::FromPy( PyObject* pyobj, qulonglong& i ) const {
+    // PyLong_AsUnsignedLongLong does not accept Python int
+    PyObject* l = PyNumber_Long( pyobj );
+    if( !l ) return false;
+    i = PyLong_AsUnsignedLongLong( l );
+    Py_DECREF( l );
+    return !( i == ( qulonglong )-1 && PyErr_Occurred() );
+}
+
+//----------------------------------------------------------------------------
+bool CharConverter::FromPy( PyObject* pyobj, QChar& c ) const {
+    if( PyUnicode_Check( pyobj ) && PyUnicode_GET_SIZE( pyobj ) == 1 ) {
+        c = QChar( ushort( PyUnicode_AS_UNICODE( pyobj )[ 0 ] ) );
+        return true;
+    } else if( PyString_Check( pyobj ) && PyString_GET_SIZE( pyobj ) == 1 ) {
+        c = QChar( PyString_AS_STRING( pyobj )[ 0 ] );
+        return true;
+    }
+    RaisePyError( "One character string required", PyExc_TypeError );
+    return false;
+}
+
+//----------------------------------------------------------------------------
+PyObject* ByteArrayConverter::ToPy( const QByteArray& b ) const {
+    if( PyType_Ready( &pyQByteArrayType ) != 0 ) return 0;
+    PyQByteArray* self = PyObject_New( PyQByteArray, &pyQByteArrayType );
+    if( !self ) return 0;
+    // shares data with b
+    new ( &self->array ) QByteArray( b );
+    return reinterpret_cast< PyObject* >( self );
+}
+
+//----------------------------------------------------------------------------
+bool ByteArrayConverter::FromPy( PyObject* pyobj, QByteArray& b ) const {
+    if( const QByteArray* a = Get( pyobj ) ) {
+        b = *a;
+        return true;
+    }
+    Py_buffer view;
+    if( PyObject_GetBuffer( pyobj, &view, PyBUF_SIMPLE ) != 0 ) return false;
+    b = QByteArray( reinterpret_cast< const char* >( view.buf ), int( view.len ) );
+    PyBuffer_Release( &view );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+const QByteArray* ByteArrayConverter::Get( PyObject* pyobj ) {
+    return Py_TYPE( pyobj ) == &pyQByteArrayType 
+           ? &reinterpret_cast< PyQByteArray* >( pyobj )->array : 0;
+}
+
+//----------------------------------------------------------------------------
+PyObject* StringListConverter::ToPy( const QStringList& l ) const {
+    PyObject* list = PyList_New( l.size() );
+    if( !list ) return 0;
+    for( int i = 0; i != l.size(); ++i ) {
+        PyObject* item = StringToPy( l.at( i ) );
+        if( !item ) {
+            Py_DECREF( list );
+            return 0;
+        }
+        PyList_SET_ITEM( list, i, item );
+    }
+    return list;
+}
+
+//----------------------------------------------------------------------------
+bool StringListConverter::FromPy( PyObject* pyobj, QStringList& l ) const {
+    PyObject* seq = PySequence_Fast( pyobj, "Sequence of strings required" );
+    if( !seq ) return false;
+    const Py_ssize_t size = PySequence_Fast_GET_SIZE( seq );
+    l.clear();
+    l.reserve( int( size ) );
+    QString s;
+    for( Py_ssize_t i = 0; i != size; ++i ) {
+        if( !PyToString( PySequence_Fast_GET_ITEM( seq, i ), s ) ) {
+            Py_DECREF( seq );
+            return false;
+        }
+        l.push_back( s );
+    }
+    Py_DECREF( seq );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+PyObject* DateConverter::ToPy( const QDate& d ) const {
+    if( !ImportDateTime() ) return 0;
+    if( !d.isValid() ) Py_RETURN_NONE;
+    return PyDate_FromDate( d.year(), d.month(), d.day() );
+}
+
+//----------------------------------------------------------------------------
+bool DateConverter::FromPy( PyObject* pyobj, QDate& d ) const {
+    if( !ImportDateTime() ) return false;
+    if( pyobj == Py_None ) {
+        d = QDate();
+        return true;
+    }
+    if( !PyDate_Check( pyobj ) ) {
+        RaisePyError( "datetime.date required", PyExc_TypeError );
+        return false;
+    }
+    d = QDate( PyDateTime_GET_YEAR( pyobj ), PyDateTime_GET_MONTH( pyobj ),
+               PyDateTime_GET_DAY( pyobj ) );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+int DateConverter::Check( PyObject* pyobj ) const {
+    if( !ImportDateTime() ) return 0;
+    // datetime.datetime is derived from datetime.date
+    return PyDate_CheckExact( pyobj ) ? 2 : PyDate_Check( pyobj ) || pyobj == Py_None;
+}
+
+//----------------------------------------------------------------------------
+PyObject* TimeConverter::ToPy( const QTime& t ) const {
+    if( !ImportDateTime() ) return 0;
+    if( !t.isValid() ) Py_RETURN_NONE;
+    return PyTime_FromTime( t.hour(), t.minute(), t.second(), t.msec() * 1000 );
+}
+
+//----------------------------------------------------------------------------
+bool TimeConverter::FromPy( PyObject* pyobj, QTime& t ) const {
+    if( !ImportDateTime() ) return false;
+    if( pyobj == Py_None ) {
+        t = QTime();
+        return true;
+    }
+    if( !PyTime_Check( pyobj ) ) {
+        RaisePyError( "datetime.time required", PyExc_TypeError );
+        return false;
+    }
+    t = QTime( PyDateTime_TIME_GET_HOUR( pyobj ), PyDateTime_TIME_GET_MINUTE( pyobj ),
+               PyDateTime_TIME_GET_SECOND( pyobj ),
+               PyDateTime_TIME_GET_MICROSECOND( pyobj ) / 1000 );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+int TimeConverter::Check( PyObject* pyobj ) const {
+    if( !ImportDateTime() ) return 0;
+    return PyTime_Check( pyobj ) ? 2 : pyobj == Py_None;
+}
+
+//----------------------------------------------------------------------------
+PyObject* DateTimeConverter::ToPy( const QDateTime& dt ) const {
+    if( !ImportDateTime() ) return 0;
+    if( !dt.isValid() ) Py_RETURN_NONE;
+    const QDate d = dt.date();
+    const QTime t = dt.time();
+    return PyDateTime_FromDateAndTime( d.year(), d.month(), d.day(), 
+                                       t.hour(), t.minute(), t.second(), t.msec() * 1000 );
+}
+
+//----------------------------------------------------------------------------
+bool DateTimeConverter::FromPy( PyObject* pyobj, QDateTime& dt ) const {
+    if( !ImportDateTime() ) return false;
+    if( pyobj == Py_None ) {
+        dt = QDateTime();
+        return true;
+    }
+    if( !PyDateTime_Check( pyobj ) ) {
+        RaisePyError( "datetime.datetime required", PyExc_TypeError );
+        return false;
+    }
+    dt = QDateTime( QDate( PyDateTime_GET_YEAR( pyobj ), PyDateTime_GET_MONTH( pyobj ),
+                           PyDateTime_GET_DAY( pyobj ) ),
+                    QTime( PyDateTime_DATE_GET_HOUR( pyobj ), PyDateTime_DATE_GET_MINUTE( pyobj ),
+                           PyDateTime_DATE_GET_SECOND( pyobj ),
+                           PyDateTime_DATE_GET_MICROSECOND( pyobj ) / 1000 ) );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+int DateTimeConverter::Check( PyObject* pyobj ) const {
+    if( !ImportDateTime() ) return 0;
+    return PyDateTime_Check( pyobj ) ? 2 : pyobj == Py_None;
+}
+
+//----------------------------------------------------------------------------
+bool UrlConverter::FromPy( PyObject* pyobj, QUrl& u ) const {
+    QString s;
+    if( !PyToString( pyobj, s ) ) return false;
+    u = QUrl( s );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool TupleConverter::Parse( PyObject* pyobj, const char* format, void* a, void* b,
+                            void* c, void* d ) {
+    if( !PyTuple_Check( pyobj ) ) {
+        RaisePyError( "Tuple required", PyExc_TypeError );
+        return false;
+    }
+    return PyArg_ParseTuple( pyobj, format, a, b, c, d ) != 0;
+}
+
+//----------------------------------------------------------------------------
+int NumericBuffer::Get( PyObject* pyobj ) {
+    if( PyString_Check( pyobj ) || PyUnicode_Check( pyobj ) ) return 0;
+    if( PyObject_CheckBuffer( pyobj ) ) {
+        if( PyObject_GetBuffer( pyobj, &view_, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS ) != 0 ) {
+            // e.g. non contiguous arrays: converted element by element
+            PyErr_Clear();
+            return 0;
+        }
+        hasView_ = true;
+        const char* f = view_.format ? view_.format : "B";
+        // native byte order only
+        if( *f == '@' || *f == '=' ) ++f;
+        if( f[ 0 ] == '\0' || f[ 1 ] != '\0' || view_.itemsize <= 0 ) {
+            RaisePyError( "Buffer format not supported", PyExc_TypeError );
+            return -1;
+        }
+        format = f[ 0 ];
+        itemSize = view_.itemsize;
+        data = view_.buf;
+        size = view_.len / view_.itemsize;
+        return 1;
+    }
+    // array.array in Python 2
+    if( !PyObject_CheckReadBuffer( pyobj ) ) return 0;
+    PyObject* typeCode = PyObject_GetAttrString( pyobj, "typecode" );
+    PyObject* is = typeCode ? PyObject_GetAttrString( pyobj, "itemsize" ) : 0;
+    if( !is || !PyString_Check( typeCode ) || PyString_GET_SIZE( typeCode ) != 1 ) {
+        Py_XDECREF( typeCode );
+        Py_XDECREF( is );
+        PyErr_Clear();
+        return 0;
+    }
+    format = PyString_AS_STRING( typeCode )[ 0 ];
+    itemSize = PyInt_AsSsize_t( is );
+    Py_DECREF( typeCode );
+    Py_DECREF( is );
+    Py_ssize_t len = 0;
+    if( itemSize <= 0 || PyObject_AsReadBuffer( pyobj, &data, &len ) != 0 ) {
+        PyErr_Clear();
+        return 0;
+    }
+    size = len / itemSize;
+    return 1;
+}
+
+//----------------------------------------------------------------------------
+PyObject* NewNumericArray( char typeCode, Py_ssize_t size, void** data ) {
+    static PyObject* arrayType = 0;
+    if( !arrayType ) {
+        PyObject* m = PyImport_ImportModule( "array" );
+        if( !m ) return 0;
+        arrayType = PyObject_GetAttrString( m, "array" );
+        Py_DECREF( m );
+        if( !arrayType ) return 0;
+    }
+    // repeating a one element array allocates the memory at once
+    PyObject* one = PyObject_CallFunction( arrayType, const_cast< char* >( "c[i]" ), typeCode, 0 );
+    if( !one ) return 0;
+    PyObject* a = PySequence_Repeat( one, size );
+    Py_DECREF( one );
+    if( !a ) return 0;
+    Py_ssize_t len = 0;
+    if( PyObject_AsWriteBuffer( a, data, &len ) != 0 ) {
+        Py_DECREF( a );
+        return 0;
+    }
+    return a;
+}
+
+//----------------------------------------------------------------------------
+PyObject* NewNumericArray( char typeCode, const void* data, Py_ssize_t size,
+                           Py_ssize_t itemSize ) {
+    void* dest = 0;
+    PyObject* a = NewNumericArray( typeCode, size, &dest );
+    if( a && size ) std::memcpy( dest, data, size * itemSize );
+    return a;
+}
+
+namespace {
+/// Python object holding a QVector of floating point values, see
+/// NumericVectorConverter.
+template < typename T >
+struct PyNumericVector {
+    PyObject_HEAD
+    QVector< T > vector;
+    /// shape and strides referenced by exported buffers
+    Py_ssize_t shape;
+    Py_ssize_t stride;
+};
+
+extern PyTypeObject pyFloatVectorType;
+extern PyTypeObject pyDoubleVectorType;
+
+/// Type object and buffer format of vector of element type T.
+template < typename T > struct NumericVectorType;
+template <> struct NumericVectorType< float > {
+    static PyTypeObject* Get() { return &pyFloatVectorType; }
+    static const char* Format() { return "f"; }
+};
+template <> struct NumericVectorType< double > {
+    static PyTypeObject* Get() { return &pyDoubleVectorType; }
+    static const char* Format() { return "d"; }
+};
+
+template < typename T >
+void PyNumericVectorDealloc( PyNumericVector< T >* self ) {
+    self->vector.~QVector< T >();
+    PyObject_Del( self );
+}
+
+template < typename T >
+Py_ssize_t PyNumericVectorLength( PyNumericVector< T >* self ) {
+    return self->vector.size();
+}
+
+template < typename T >
+PyObject* PyNumericVectorItem( PyNumericVector< T >* self, Py_ssize_t i ) {
+    if( i < 0 || i >= self->vector.size() ) {
+        RaisePyError( "Index out of range", PyExc_IndexError );
+        return 0;
+    }
+    return PyFloat_FromDouble( self->vector.at( int( i ) ) );
+}
+
+/// Read-only buffer exporting the vector data; the buffer references the
+/// Python object, which keeps the QVector alive.
+template < typename T >
+int PyNumericVectorGetBuffer( PyNumericVector< T >* self, Py_buffer* view, int flags ) {
+    if( ( flags & PyBUF_WRITABLE ) == PyBUF_WRITABLE ) {
+        RaisePyError( "Vector data are read-only", PyExc_BufferError );
+        return -1;
+    }
+    Py_INCREF( self );
+    view->obj = reinterpret_cast< PyObject* >( self );
+    view->buf = const_cast< T* >( self->vector.constData() );
+    view->len = self->shape * self->stride;
+    view->readonly = 1;
+    view->itemsize = self->stride;
+    view->format = ( flags & PyBUF_FORMAT ) == PyBUF_FORMAT
+                   ? const_cast< char* >( NumericVectorType< T >::Format() ) : 0;
+    view->ndim = 1;
+    view->shape = ( flags & PyBUF_ND ) == PyBUF_ND ? &self->shape : 0;
+    view->strides = ( flags & PyBUF_STRIDES ) == PyBUF_STRIDES ? &self->stride : 0;
+    view->suboffsets = 0;
+    view->internal = 0;
+    return 0;
+}
+
+/// Old-style buffer interface, used by Python 2 functions such as @c file.write.
+template < typename T >
+Py_ssize_t PyNumericVectorGetReadBuffer( PyNumericVector< T >* self, Py_ssize_t segment, void** p ) {
+    if( segment != 0 ) {
+        RaisePyError( "Accessing non-existent segment", PyExc_SystemError );
+        return -1;
+    }
+    *p = const_cast< T* >( self->vector.constData() );
+    return self->shape * self->stride;
+}
+
+template < typename T >
+Py_ssize_t PyNumericVectorGetSegCount( PyNumericVector< T >* self, Py_ssize_t* len ) {
+    if( len ) *len = self->shape * self->stride;
+    return 1;
+}
+
+/// numpy array interface, version 3; arrays created from the interface
+/// reference the Python object.
+template < typename T >
+PyObject* PyNumericVectorArrayInterface( PyNumericVector< T >* self, void* ) {
+    const ushort one = 1;
+    const char byteOrder = *reinterpret_cast< const char* >( &one ) ? '<' : '>';
+    char typeStr[ 4 ] = { byteOrder, 'f', char( '0' + sizeof( T ) ), 0 };
+    return Py_BuildValue( "{s:(n),s:s,s:(N,O),s:i}",
+                          "shape", self->shape,
+                          "typestr", typeStr,
+                          "data", PyLong_FromVoidPtr( const_cast< T* >( self->vector.constData() ) ),
+                          Py_True,
+                          "version", 3 );
+}
+
+template < typename T >
+PyObject* NewPyNumericVector( const QVector< T >& v ) {
+    PyTypeObject* type = NumericVectorType< T >::Get();
+    if( PyType_Ready( type ) != 0 ) return 0;
+    PyNumericVector< T >* self = PyObject_New( PyNumericVector< T >, type );
+    if( !self ) return 0;
+    // shares data with v
+    new ( &self->vector ) QVector< T >( v );
+    self->shape = v.size();
+    self->stride = sizeof( T );
+    return reinterpret_cast< PyObject* >( self );
+}
+
+template < typename T >
+const QVector< T >* GetPyNumericVector( PyObject* pyobj ) {
+    return Py_TYPE( pyobj ) == NumericVectorType< T >::Get()
+           ? &reinterpret_cast< PyNumericVector< T >* >( pyobj )->vector : 0;
+}
+
+template < typename T >
+struct PyNumericVectorSlots {
+    static PySequenceMethods sequence;
+    static PyBufferProcs buffer;
+    static PyGetSetDef getSet[];
+};
+
+template < typename T >
+PySequenceMethods PyNumericVectorSlots< T >::sequence = {
+    reinterpret_cast< lenfunc >( &PyNumericVectorLength< T > ),   /*sq_length*/
+    0,                                                             /*sq_concat*/
+    0,                                                             /*sq_repeat*/
+    reinterpret_cast< ssizeargfunc >( &PyNumericVectorItem< T > ) /*sq_item*/
+};
+
+template < typename T >
+PyBufferProcs PyNumericVectorSlots< T >::buffer = {
+    reinterpret_cast< readbufferproc >( &PyNumericVectorGetReadBuffer< T > ), /*bf_getreadbuffer*/
+    0,                                                                         /*bf_getwritebuffer*/
+    reinterpret_cast< segcountproc >( &PyNumericVectorGetSegCount< T > ),     /*bf_getsegcount*/
+    0,                                                                         /*bf_getcharbuffer*/
+    reinterpret_cast< getbufferproc >( &PyNumericVectorGetBuffer< T > ),      /*bf_getbuffer*/
+    0                                                                          /*bf_releasebuffer*/
+};
+
+template < typename T >
+PyGetSetDef PyNumericVectorSlots< T >::getSet[] = {
+    { const_cast< char* >( "__array_interface__" ),
+      reinterpret_cast< getter >( &PyNumericVectorArrayInterface< T > ), 0,
+      const_cast< char* >( "numpy array interface" ), 0 },
+    { 0 }
+};
+
+PyTypeObject pyFloatVectorType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.FloatVector",         /*tp_name*/
+    sizeof( PyNumericVector< float > ), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( &PyNumericVectorDealloc< float > ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    &PyNumericVectorSlots< float >::sequence, /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    &PyNumericVectorSlots< float >::buffer, /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER, /*tp_flags*/
+    "QVector<float> data exported through the buffer protocol", /* tp_doc */
+    0,                         /*tp_traverse*/
+    0,                         /*tp_clear*/
+    0,                         /*tp_richcompare*/
+    0,                         /*tp_weaklistoffset*/
+    0,                         /*tp_iter*/
+    0,                         /*tp_iternext*/
+    0,                         /*tp_methods*/
+    0,                         /*tp_members*/
+    PyNumericVectorSlots< float >::getSet /*tp_getset*/
+};
+
+PyTypeObject pyDoubleVectorType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.DoubleVector",        /*tp_name*/
+    sizeof( PyNumericVector< double > ), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( &PyNumericVectorDealloc< double > ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    &PyNumericVectorSlots< double >::sequence, /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    &PyNumericVectorSlots< double >::buffer, /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER, /*tp_flags*/
+    "QVector<double> data exported through the buffer protocol", /* tp_doc */
+    0,                         /*tp_traverse*/
+    0,                         /*tp_clear*/
+    0,                         /*tp_richcompare*/
+    0,                         /*tp_weaklistoffset*/
+    0,                         /*tp_iter*/
+    0,                         /*tp_iternext*/
+    0,                         /*tp_methods*/
+    0,                         /*tp_members*/
+    PyNumericVectorSlots< double >::getSet /*tp_getset*/
+};
+}
+
+//----------------------------------------------------------------------------
+PyObject* NumericVectorToPy( const QVector< float >& v ) {
+    return NewPyNumericVector( v );
+}
+
+//----------------------------------------------------------------------------
+PyObject* NumericVectorToPy( const QVector< double >& v ) {
+    return NewPyNumericVector( v );
+}
+
+//----------------------------------------------------------------------------
+const QVector< float >* NumericVectorGet( PyObject* pyobj, float* ) {
+    return GetPyNumericVector< float >( pyobj );
+}
+
+//----------------------------------------------------------------------------
+const QVector< double >* NumericVectorGet( PyObject* pyobj, double* ) {
+    return GetPyNumericVector< double >( pyobj );
+}
+
+}
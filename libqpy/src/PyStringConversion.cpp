@@ -0,0 +1,136 @@
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QVector>
+#include <QHash>
+#include "../include/detail/PyStringConversion.h"
+#include "../include/PyContext.h"
+
+namespace qpy {
+
+namespace {
+struct StringCacheEntry {
+    QString key;
+    PyObject* value;
+    StringCacheEntry() : value( 0 ) {}
+};
+QVector< StringCacheEntry > stringCache;
+
+/// Decode UTF-16 text containing surrogate pairs.
+PyObject* DecodeUTF16( const ushort* p, int n ) {
+    const ushort one = 1;
+    int byteOrder = *reinterpret_cast< const char* >( &one ) ? -1 : 1;
+    return PyUnicode_DecodeUTF16( reinterpret_cast< const char* >( p ),
+                                  Py_ssize_t( n ) * 2, 0, &byteOrder );
+}
+
+PyObject* NewPyString( const QString& s ) {
+    const ushort* p = s.utf16();
+    const int n = s.size();
+    ushort bits = 0;
+    for( int i = 0; i != n; ++i ) bits |= p[ i ];
+    if( bits < 0x80 ) {
+        PyObject* str = PyString_FromStringAndSize( 0, n );
+        if( !str ) return 0;
+        char* d = PyString_AS_STRING( str );
+        for( int i = 0; i != n; ++i ) d[ i ] = char( p[ i ] );
+        return str;
+    }
+    if( sizeof( Py_UNICODE ) == sizeof( ushort ) ) {
+        return PyUnicode_FromUnicode( reinterpret_cast< const Py_UNICODE* >( p ), n );
+    }
+    // UCS4 build: widen code units, surrogate pairs are rare and go through
+    // the UTF-16 codec
+    PyObject* u = PyUnicode_FromUnicode( 0, n );
+    if( !u ) return 0;
+    Py_UNICODE* d = PyUnicode_AS_UNICODE( u );
+    for( int i = 0; i != n; ++i ) {
+        if( ( p[ i ] & 0xF800 ) == 0xD800 ) {
+            Py_DECREF( u );
+            return DecodeUTF16( p, n );
+        }
+        d[ i ] = p[ i ];
+    }
+    return u;
+}
+}
+
+//----------------------------------------------------------------------------
+PyObject* StringToPy( const QString& s ) {
+    if( stringCache.isEmpty() || s.size() > STRING_CACHE_MAX_LENGTH ) {
+        return NewPyString( s );
+    }
+    StringCacheEntry& e = stringCache[ qHash( s ) % uint( stringCache.size() ) ];
+    if( e.value && e.key == s ) {
+        Py_INCREF( e.value );
+        return e.value;
+    }
+    PyObject* str = NewPyString( s );
+    if( !str ) return 0;
+    Py_XDECREF( e.value );
+    Py_INCREF( str );
+    e.key = s;
+    e.value = str;
+    return str;
+}
+
+//----------------------------------------------------------------------------
+bool PyToString( PyObject* pyobj, QString& s ) {
+    if( PyUnicode_Check( pyobj ) ) {
+        const Py_UNICODE* u = PyUnicode_AS_UNICODE( pyobj );
+        const int n = int( PyUnicode_GET_SIZE( pyobj ) );
+        if( sizeof( Py_UNICODE ) == sizeof( QChar ) ) {
+            s = QString( reinterpret_cast< const QChar* >( u ), n );
+        } else {
+            s = QString::fromUcs4( reinterpret_cast< const uint* >( u ), n );
+        }
+        return true;
+    } else if( PyString_Check( pyobj ) ) {
+        const char* c = PyString_AS_STRING( pyobj );
+        const int n = int( PyString_GET_SIZE( pyobj ) );
+        char bits = 0;
+        for( int i = 0; i != n; ++i ) bits |= c[ i ];
+        s = bits & 0x80 ? QString::fromUtf8( c, n ) : QString::fromLatin1( c, n );
+        return true;
+    }
+    RaisePyError( "String required", PyExc_TypeError );
+    return false;
+}
+
+//----------------------------------------------------------------------------
+void SetStringCacheSize( int entries ) {
+    for( QVector< StringCacheEntry >::iterator i = stringCache.begin();
+         i != stringCache.end(); ++i ) {
+        Py_XDECREF( i->value );
+    }
+    stringCache.clear();
+    if( entries > 0 ) stringCache.resize( entries );
+}
+
+//----------------------------------------------------------------------------
+int StringCacheSize() {
+    return stringCache.size();
+}
+}
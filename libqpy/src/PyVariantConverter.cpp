@@ -0,0 +1,298 @@
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Python.h>
+#include <datetime.h>
+#include <climits>
+#include <QVector>
+#include "../include/detail/PyVariantConverter.h"
+#include "../include/detail/PyStringConversion.h"
+#include "../include/PyContext.h"
+
+namespace qpy {
+
+namespace {
+/// The datetime C API is imported on first use, when the interpreter is
+/// already initialized; the PyDateTimeAPI pointer is local to this file.
+bool ImportDateTime() {
+    if( !PyDateTimeAPI ) PyDateTime_IMPORT;
+    return PyDateTimeAPI != 0;
+}
+
+bool IsContainer( int type ) {
+    return type == QMetaType::QVariantList || type == QMetaType::QVariantMap
+           || type == QMetaType::QVariantHash;
+}
+
+/// Qt container being converted to Python.
+struct ToPyFrame {
+    /// Python container, borrowed from parent container
+    PyObject* obj;
+    int type;
+    const QVariantList* list;
+    int index;
+    QVariantMap::const_iterator mi;
+    QVariantMap::const_iterator mend;
+    QVariantHash::const_iterator hi;
+    QVariantHash::const_iterator hend;
+};
+
+/// Create Python container with the size of the Qt container and push it
+/// on the stack; elements are added when the frame is traversed.
+/// @return new reference or NULL in case of error
+PyObject* PushContainer( const QVariant& v, QVector< ToPyFrame >& stack ) {
+    ToPyFrame f;
+    f.type = v.userType();
+    f.list = 0;
+    f.index = 0;
+    if( f.type == QMetaType::QVariantList ) {
+        f.list = reinterpret_cast< const QVariantList* >( v.constData() );
+        f.obj = PyList_New( f.list->size() );
+    } else if( f.type == QMetaType::QVariantMap ) {
+        const QVariantMap* m = reinterpret_cast< const QVariantMap* >( v.constData() );
+        f.mi = m->begin();
+        f.mend = m->end();
+        f.obj = _PyDict_NewPresized( m->size() );
+    } else {
+        const QVariantHash* h = reinterpret_cast< const QVariantHash* >( v.constData() );
+        f.hi = h->begin();
+        f.hend = h->end();
+        f.obj = _PyDict_NewPresized( h->size() );
+    }
+    if( f.obj ) stack.push_back( f );
+    return f.obj;
+}
+
+/// Python container being converted to Qt.
+struct FromPyFrame {
+    /// Python container, borrowed from parent container
+    PyObject* obj;
+    int type;
+    /// position of next element
+    Py_ssize_t pos;
+    /// key of container in parent dict
+    QString key;
+    QVariantList list;
+    QVariantMap map;
+    QVariantHash hash;
+};
+
+FromPyFrame NewFrame( PyObject* obj, int type, const QString& key ) {
+    FromPyFrame f;
+    f.obj = obj;
+    f.type = type;
+    f.pos = 0;
+    f.key = key;
+    if( type == QMetaType::QVariantList ) f.list.reserve( int( PySequence_Fast_GET_SIZE( obj ) ) );
+    else if( type == QMetaType::QVariantHash ) f.hash.reserve( int( PyDict_Size( obj ) ) );
+    return f;
+}
+
+void AddElement( FromPyFrame& f, const QString& key, const QVariant& v ) {
+    if( f.type == QMetaType::QVariantList ) f.list.append( v );
+    else if( f.type == QMetaType::QVariantMap ) f.map.insert( key, v );
+    else f.hash.insert( key, v );
+}
+
+/// Return container type matching Python object, 0 if not a container.
+int ContainerType( PyObject* obj, int dictType ) {
+    if( PyList_Check( obj ) || PyTuple_Check( obj ) ) return QMetaType::QVariantList;
+    return PyDict_Check( obj ) ? dictType : 0;
+}
+
+/// Return meta type of QVariant created from Python object; QMetaType::Void
+/// for @c None, -1 if not supported.
+int PyObjectMetaType( PyObject* obj ) {
+    if( obj == Py_None ) return QMetaType::Void;
+    if( PyBool_Check( obj ) ) return QMetaType::Bool;
+    if( PyInt_Check( obj ) ) {
+        const long i = PyInt_AS_LONG( obj );
+        return i >= INT_MIN && i <= INT_MAX ? QMetaType::Int : QMetaType::LongLong;
+    }
+    if( PyLong_Check( obj ) ) return QMetaType::LongLong;
+    if( PyFloat_Check( obj ) ) return QMetaType::Double;
+    if( PyString_Check( obj ) || PyUnicode_Check( obj ) ) return QMetaType::QString;
+    if( ByteArrayConverter::Get( obj ) ) return QMetaType::QByteArray;
+    if( ImportDateTime() ) {
+        // datetime is derived from date
+        if( PyDateTime_Check( obj ) ) return QMetaType::QDateTime;
+        if( PyDate_Check( obj ) ) return QMetaType::QDate;
+        if( PyTime_Check( obj ) ) return QMetaType::QTime;
+    } else PyErr_Clear();
+    return -1;
+}
+}
+
+//----------------------------------------------------------------------------
+PyObject* VariantConverter::QVariantToPy( const QVariant& v ) const {
+    if( !IsContainer( v.userType() ) ) return ElementToPy( v );
+    QVector< ToPyFrame > stack;
+    PyObject* root = PushContainer( v, stack );
+    if( !root ) return 0;
+    while( !stack.isEmpty() ) {
+        // pushing a nested container invalidates the reference
+        ToPyFrame& f = stack.back();
+        PyObject* parent = f.obj;
+        const QVariant* item = 0;
+        PyObject* key = 0;
+        int index = -1;
+        if( f.type == QMetaType::QVariantList ) {
+            if( f.index != f.list->size() ) {
+                index = f.index++;
+                item = &f.list->at( index );
+            }
+        } else if( f.type == QMetaType::QVariantMap ) {
+            if( f.mi != f.mend ) {
+                key = StringToPy( f.mi.key() );
+                item = &f.mi.value();
+                ++f.mi;
+            }
+        } else if( f.hi != f.hend ) {
+            key = StringToPy( f.hi.key() );
+            item = &f.hi.value();
+            ++f.hi;
+        }
+        if( !item ) {
+            stack.pop_back();
+            continue;
+        }
+        PyObject* value = 0;
+        if( index >= 0 || key ) {
+            value = IsContainer( item->userType() ) ? PushContainer( *item, stack )
+                                                    : ElementToPy( *item );
+        }
+        if( !value ) {
+            Py_XDECREF( key );
+            Py_DECREF( root );
+            return 0;
+        }
+        if( index >= 0 ) PyList_SET_ITEM( parent, index, value );
+        else {
+            // nested containers are kept alive by the parent dict
+            const int r = PyDict_SetItem( parent, key, value );
+            Py_DECREF( key );
+            Py_DECREF( value );
+            if( r != 0 ) {
+                Py_DECREF( root );
+                return 0;
+            }
+        }
+    }
+    return root;
+}
+
+//----------------------------------------------------------------------------
+bool VariantConverter::PyToQVariant( PyObject* pyobj, QVariant& v, int type ) const {
+    if( type != QMetaType::QVariant && !CheckContainer( pyobj, type ) ) {
+        RaisePyError( type == QMetaType::QVariantList ? "List or tuple required"
+                                                      : "Dict required", PyExc_TypeError );
+        return false;
+    }
+    const int dictType = type == QMetaType::QVariantHash ? type : int( QMetaType::QVariantMap );
+    const int rootType = ContainerType( pyobj, dictType );
+    if( !rootType ) return PyToElement( pyobj, v );
+    QVector< FromPyFrame > stack;
+    stack.push_back( NewFrame( pyobj, rootType, QString() ) );
+    while( true ) {
+        // pushing a nested container invalidates the reference
+        FromPyFrame& f = stack.back();
+        PyObject* item = 0;
+        QString key;
+        if( f.type == QMetaType::QVariantList ) {
+            if( f.pos < PySequence_Fast_GET_SIZE( f.obj ) ) {
+                item = PySequence_Fast_GET_ITEM( f.obj, f.pos++ );
+            }
+        } else {
+            PyObject* k = 0;
+            if( PyDict_Next( f.obj, &f.pos, &k, &item ) && !PyToString( k, key ) ) return false;
+        }
+        if( !item ) {
+            const QVariant c = f.type == QMetaType::QVariantList ? QVariant( f.list )
+                               : f.type == QMetaType::QVariantMap ? QVariant( f.map )
+                               : QVariant( f.hash );
+            key = f.key;
+            stack.pop_back();
+            if( stack.isEmpty() ) {
+                v = c;
+                return true;
+            }
+            AddElement( stack.back(), key, c );
+            continue;
+        }
+        const int itemType = ContainerType( item, QMetaType::QVariantMap );
+        if( itemType ) {
+            for( QVector< FromPyFrame >::const_iterator i = stack.begin();
+                 i != stack.end(); ++i ) {
+                if( i->obj == item ) {
+                    RaisePyError( "Cyclic reference in container", PyExc_ValueError );
+                    return false;
+                }
+            }
+            stack.push_back( NewFrame( item, itemType, key ) );
+            continue;
+        }
+        QVariant e;
+        if( !PyToElement( item, e ) ) return false;
+        AddElement( f, key, e );
+    }
+}
+
+//----------------------------------------------------------------------------
+int VariantConverter::CheckContainer( PyObject* pyobj, int type ) {
+    if( type == QMetaType::QVariantList ) {
+        return PyList_Check( pyobj ) || PyTuple_Check( pyobj ) ? 2 : 0;
+    }
+    return PyDict_Check( pyobj ) ? 2 : 0;
+}
+
+//----------------------------------------------------------------------------
+PyObject* VariantConverter::ElementToPy( const QVariant& v ) const {
+    if( !v.isValid() ) Py_RETURN_NONE;
+    const QVariantToPyObject* c = ctx_->FindQVariantToPyObject( v.userType() );
+    if( !c ) {
+        RaisePyError( qPrintable( QString( "No converter for QVariant type " ) + v.typeName() ),
+                      PyExc_TypeError );
+        return 0;
+    }
+    return c->Create( v );
+}
+
+//----------------------------------------------------------------------------
+bool VariantConverter::PyToElement( PyObject* pyobj, QVariant& v ) const {
+    const int type = PyObjectMetaType( pyobj );
+    if( type == QMetaType::Void ) {
+        v = QVariant();
+        return true;
+    }
+    const PyObjectToQVariant* c = type > 0 ? ctx_->FindPyObjectToQVariant( type ) : 0;
+    if( !c ) {
+        RaisePyError( qPrintable( QString( "Cannot convert " ) + Py_TYPE( pyobj )->tp_name
+                                  + " to QVariant" ), PyExc_TypeError );
+        return false;
+    }
+    v = c->Create( pyobj );
+    return !PyErr_Occurred();
+}
+}
@@ -0,0 +1,399 @@
+// QPy - Copyright (c) 2012,2013 Ugo Varetto
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author and copyright holder nor the
+//       names of contributors to the project may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <new>
+#include "../include/detail/PyVariantView.h"
+#include "../include/detail/PyStringConversion.h"
+#include "../include/PyContext.h"
+
+namespace qpy {
+
+namespace {
+/// Python object holding a QVariant container.
+template < typename T >
+struct PyVariantView {
+    PyObject_HEAD
+    T container;
+    VariantConverter converter;
+};
+
+/// Iterator over the keys of a QVariantMap or QVariantHash view.
+template < typename T >
+struct PyVariantKeyIter {
+    PyObject_HEAD
+    /// view referenced to keep the container alive
+    PyObject* view;
+    typename T::const_iterator i;
+    typename T::const_iterator end;
+};
+
+extern PyTypeObject pyListViewType;
+extern PyTypeObject pyMapViewType;
+extern PyTypeObject pyHashViewType;
+extern PyTypeObject pyMapKeyIterType;
+extern PyTypeObject pyHashKeyIterType;
+
+template < typename T >
+PyObject* NewView( PyTypeObject& type, const QVariant& v, const VariantConverter& c ) {
+    if( PyType_Ready( &type ) != 0 ) return 0;
+    PyVariantView< T >* self = PyObject_New( PyVariantView< T >, &type );
+    if( !self ) return 0;
+    // shares data with v
+    new ( &self->container ) T( *reinterpret_cast< const T* >( v.constData() ) );
+    new ( &self->converter ) VariantConverter( c );
+    return reinterpret_cast< PyObject* >( self );
+}
+
+template < typename T >
+void ViewDealloc( PyVariantView< T >* self ) {
+    self->container.~T();
+    self->converter.~VariantConverter();
+    PyObject_Del( self );
+}
+
+template < typename T >
+Py_ssize_t ViewLength( PyVariantView< T >* self ) {
+    return self->container.size();
+}
+
+PyObject* ListViewItem( PyVariantView< QVariantList >* self, Py_ssize_t i ) {
+    if( i < 0 || i >= self->container.size() ) {
+        RaisePyError( "Index out of range", PyExc_IndexError );
+        return 0;
+    }
+    return NewVariantView( self->container.at( int( i ) ), self->converter );
+}
+
+/// Elements are converted one at a time and compared with the Python object.
+int ListViewContains( PyVariantView< QVariantList >* self, PyObject* obj ) {
+    for( QVariantList::const_iterator i = self->container.constBegin();
+         i != self->container.constEnd(); ++i ) {
+        // nested containers are converted to Python containers: views do
+        // not support comparison
+        PyObject* e = self->converter.QVariantToPy( *i );
+        if( !e ) return -1;
+        const int r = PyObject_RichCompareBool( e, obj, Py_EQ );
+        Py_DECREF( e );
+        if( r != 0 ) return r;
+    }
+    return 0;
+}
+
+template < typename T >
+PyObject* MapViewSubscript( PyVariantView< T >* self, PyObject* key ) {
+    QString k;
+    if( !PyToString( key, k ) ) return 0;
+    typename T::const_iterator i = self->container.constFind( k );
+    if( i == self->container.constEnd() ) {
+        PyErr_SetObject( PyExc_KeyError, key );
+        return 0;
+    }
+    return NewVariantView( i.value(), self->converter );
+}
+
+template < typename T >
+int MapViewContains( PyVariantView< T >* self, PyObject* key ) {
+    if( !PyString_Check( key ) && !PyUnicode_Check( key ) ) return 0;
+    QString k;
+    if( !PyToString( key, k ) ) return -1;
+    return self->container.contains( k ) ? 1 : 0;
+}
+
+template < typename T >
+PyObject* MapViewKeys( PyVariantView< T >* self ) {
+    PyObject* keys = PyList_New( self->container.size() );
+    if( !keys ) return 0;
+    Py_ssize_t n = 0;
+    for( typename T::const_iterator i = self->container.constBegin();
+         i != self->container.constEnd(); ++i, ++n ) {
+        PyObject* k = StringToPy( i.key() );
+        if( !k ) {
+            Py_DECREF( keys );
+            return 0;
+        }
+        PyList_SET_ITEM( keys, n, k );
+    }
+    return keys;
+}
+
+template < typename T >
+PyObject* MapViewGet( PyVariantView< T >* self, PyObject* args ) {
+    PyObject* key = 0;
+    PyObject* def = Py_None;
+    if( !PyArg_UnpackTuple( args, "get", 1, 2, &key, &def ) ) return 0;
+    QString k;
+    if( !PyToString( key, k ) ) return 0;
+    typename T::const_iterator i = self->container.constFind( k );
+    if( i == self->container.constEnd() ) {
+        Py_INCREF( def );
+        return def;
+    }
+    return NewVariantView( i.value(), self->converter );
+}
+
+template < typename T >
+PyObject* MapViewIter( PyVariantView< T >* self, PyTypeObject* iterType ) {
+    if( PyType_Ready( iterType ) != 0 ) return 0;
+    PyVariantKeyIter< T >* it = PyObject_New( PyVariantKeyIter< T >, iterType );
+    if( !it ) return 0;
+    Py_INCREF( self );
+    it->view = reinterpret_cast< PyObject* >( self );
+    new ( &it->i ) typename T::const_iterator( self->container.constBegin() );
+    new ( &it->end ) typename T::const_iterator( self->container.constEnd() );
+    return reinterpret_cast< PyObject* >( it );
+}
+
+PyObject* MapViewIterMap( PyVariantView< QVariantMap >* self ) {
+    return MapViewIter( self, &pyMapKeyIterType );
+}
+
+PyObject* MapViewIterHash( PyVariantView< QVariantHash >* self ) {
+    return MapViewIter( self, &pyHashKeyIterType );
+}
+
+template < typename T >
+void KeyIterDealloc( PyVariantKeyIter< T >* self ) {
+    Py_DECREF( self->view );
+    PyObject_Del( self );
+}
+
+template < typename T >
+PyObject* KeyIterNext( PyVariantKeyIter< T >* self ) {
+    // NULL without exception set: StopIteration
+    if( self->i == self->end ) return 0;
+    PyObject* k = StringToPy( self->i.key() );
+    ++self->i;
+    return k;
+}
+
+PySequenceMethods pyListViewSequence = {
+    reinterpret_cast< lenfunc >( &ViewLength< QVariantList > ),    /*sq_length*/
+    0,                                                              /*sq_concat*/
+    0,                                                              /*sq_repeat*/
+    reinterpret_cast< ssizeargfunc >( ListViewItem ),              /*sq_item*/
+    0,                                                              /*sq_slice*/
+    0,                                                              /*sq_ass_item*/
+    0,                                                              /*sq_ass_slice*/
+    reinterpret_cast< objobjproc >( ListViewContains )             /*sq_contains*/
+};
+
+PySequenceMethods pyMapViewSequence = {
+    0, 0, 0, 0, 0, 0, 0,
+    reinterpret_cast< objobjproc >( &MapViewContains< QVariantMap > ) /*sq_contains*/
+};
+
+PySequenceMethods pyHashViewSequence = {
+    0, 0, 0, 0, 0, 0, 0,
+    reinterpret_cast< objobjproc >( &MapViewContains< QVariantHash > ) /*sq_contains*/
+};
+
+PyMappingMethods pyMapViewMapping = {
+    reinterpret_cast< lenfunc >( &ViewLength< QVariantMap > ),        /*mp_length*/
+    reinterpret_cast< binaryfunc >( &MapViewSubscript< QVariantMap > ) /*mp_subscript*/
+};
+
+PyMappingMethods pyHashViewMapping = {
+    reinterpret_cast< lenfunc >( &ViewLength< QVariantHash > ),        /*mp_length*/
+    reinterpret_cast< binaryfunc >( &MapViewSubscript< QVariantHash > ) /*mp_subscript*/
+};
+
+PyMethodDef pyMapViewMethods[] = {
+    { "keys", reinterpret_cast< PyCFunction >( &MapViewKeys< QVariantMap > ), METH_NOARGS,
+      "Return list of keys" },
+    { "get", reinterpret_cast< PyCFunction >( &MapViewGet< QVariantMap > ), METH_VARARGS,
+      "Return value of key or default value if key not found" },
+    { 0 }
+};
+
+PyMethodDef pyHashViewMethods[] = {
+    { "keys", reinterpret_cast< PyCFunction >( &MapViewKeys< QVariantHash > ), METH_NOARGS,
+      "Return list of keys" },
+    { "get", reinterpret_cast< PyCFunction >( &MapViewGet< QVariantHash > ), METH_VARARGS,
+      "Return value of key or default value if key not found" },
+    { 0 }
+};
+
+PyTypeObject pyListViewType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.VariantListView",     /*tp_name*/
+    sizeof( PyVariantView< QVariantList > ), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( &ViewDealloc< QVariantList > ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    &pyListViewSequence,       /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "Read-only view of QVariantList, elements converted on access" /* tp_doc */
+};
+
+PyTypeObject pyMapViewType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.VariantMapView",      /*tp_name*/
+    sizeof( PyVariantView< QVariantMap > ), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( &ViewDealloc< QVariantMap > ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    &pyMapViewSequence,        /*tp_as_sequence*/
+    &pyMapViewMapping,         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "Read-only view of QVariantMap, values converted on access", /* tp_doc */
+    0,                         /*tp_traverse*/
+    0,                         /*tp_clear*/
+    0,                         /*tp_richcompare*/
+    0,                         /*tp_weaklistoffset*/
+    reinterpret_cast< getiterfunc >( MapViewIterMap ), /*tp_iter*/
+    0,                         /*tp_iternext*/
+    pyMapViewMethods           /*tp_methods*/
+};
+
+PyTypeObject pyHashViewType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.VariantHashView",     /*tp_name*/
+    sizeof( PyVariantView< QVariantHash > ), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( &ViewDealloc< QVariantHash > ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    &pyHashViewSequence,       /*tp_as_sequence*/
+    &pyHashViewMapping,        /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "Read-only view of QVariantHash, values converted on access", /* tp_doc */
+    0,                         /*tp_traverse*/
+    0,                         /*tp_clear*/
+    0,                         /*tp_richcompare*/
+    0,                         /*tp_weaklistoffset*/
+    reinterpret_cast< getiterfunc >( MapViewIterHash ), /*tp_iter*/
+    0,                         /*tp_iternext*/
+    pyHashViewMethods          /*tp_methods*/
+};
+
+PyTypeObject pyMapKeyIterType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.VariantMapKeyIterator", /*tp_name*/
+    sizeof( PyVariantKeyIter< QVariantMap > ), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( &KeyIterDealloc< QVariantMap > ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    0,                         /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "Iterator over QVariantMap view keys", /* tp_doc */
+    0,                         /*tp_traverse*/
+    0,                         /*tp_clear*/
+    0,                         /*tp_richcompare*/
+    0,                         /*tp_weaklistoffset*/
+    PyObject_SelfIter,         /*tp_iter*/
+    reinterpret_cast< iternextfunc >( &KeyIterNext< QVariantMap > ) /*tp_iternext*/
+};
+
+PyTypeObject pyHashKeyIterType = {
+    PyObject_HEAD_INIT( 0 )
+    0,                         /*ob_size*/
+    "qpy.VariantHashKeyIterator", /*tp_name*/
+    sizeof( PyVariantKeyIter< QVariantHash > ), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    reinterpret_cast< destructor >( &KeyIterDealloc< QVariantHash > ), /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    0,                         /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "Iterator over QVariantHash view keys", /* tp_doc */
+    0,                         /*tp_traverse*/
+    0,                         /*tp_clear*/
+    0,                         /*tp_richcompare*/
+    0,                         /*tp_weaklistoffset*/
+    PyObject_SelfIter,         /*tp_iter*/
+    reinterpret_cast< iternextfunc >( &KeyIterNext< QVariantHash > ) /*tp_iternext*/
+};
+}
+
+//----------------------------------------------------------------------------
+PyObject* NewVariantView( const QVariant& v, const VariantConverter& c ) {
+    switch( v.userType() ) {
+    case QMetaType::QVariantList: return NewView< QVariantList >( pyListViewType, v, c );
+    case QMetaType::QVariantMap: return NewView< QVariantMap >( pyMapViewType, v, c );
+    case QMetaType::QVariantHash: return NewView< QVariantHash >( pyHashViewType, v, c );
+    default: return c.QVariantToPy( v );
+    }
+}
+}
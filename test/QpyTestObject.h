@@ -26,20 +26,96 @@
 
 #include <iostream>
 #include <QObject>
+#include <QMetaType>
+#include <QStringList>
+#include <QDateTime>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+#include <QList>
+#include <QVariant>
+#include <QThread>
+#include <QPointer>
+/// Type with converters registered by the test driver.
+struct QpyTestPoint {
+    double x;
+    double y;
+    QpyTestPoint() : x( 0 ), y( 0 ) {}
+};
+Q_DECLARE_METATYPE( QpyTestPoint )
+/// Added to the context after QpyTestObject.
+class QpyTestPeer;
 class QpyTestObject : public QObject {
     Q_OBJECT
     Q_PROPERTY( int value READ GetValue WRITE SetValue )
+    Q_PROPERTY( QString text READ GetText WRITE SetText )
+    Q_PROPERTY( double ratio READ GetRatio WRITE SetRatio )
+    Q_PROPERTY( QpyTestPoint point READ GetPoint WRITE SetPoint )
+    Q_PROPERTY( QSize size READ GetSize WRITE SetSize )
+    Q_PROPERTY( QObject* object READ Self )
+    Q_PROPERTY( QpyTestObject* link READ GetLink WRITE SetLink )
 public:
-    Q_INVOKABLE QpyTestObject() : QObject( 0 ) {}
-    Q_INVOKABLE QpyTestObject( int value ) : QObject( 0 ), value_( value ) {}
+    Q_INVOKABLE QpyTestObject() : QObject( 0 ), ratio_( 0 ) {}
+    Q_INVOKABLE QpyTestObject( int value ) : QObject( 0 ), value_( value ), ratio_( 0 ) {}
+    Q_INVOKABLE QpyTestObject( int a1, int a2, int a3, int a4, int a5, int a6,
+                               int a7, int a8, int a9, int a10, int a11 )
+        : QObject( 0 ), value_( a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 ),
+          ratio_( 0 ) {}
 public slots:
     QString copyString( const QString& s ) { return s; }
     float copyFloat( float f ) { return f; }
     double copyDouble( double d ) { return d; }
     int copyInt( int i ) { return i; }
+    int sum( int a1, int a2, int a3, int a4, int a5, int a6,
+             int a7, int a8, int a9, int a10, int a11 ) const {
+        return a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11;
+    }
     int GetValue() const { return value_; }
     void SetValue( int v ) { value_ = v; }
     void SetDefaultValue() { value_ = 0; }
+    QString GetText() const { return text_; }
+    void SetText( const QString& t ) { text_ = t; }
+    double GetRatio() const { return ratio_; }
+    void SetRatio( double r ) { ratio_ = r; }
+    QpyTestPoint GetPoint() const { return point_; }
+    void SetPoint( const QpyTestPoint& p ) { point_ = p; }
+    QpyTestPoint copyPoint( const QpyTestPoint& p ) const { return p; }
+    QSize GetSize() const { return size_; }
+    void SetSize( const QSize& s ) { size_ = s; }
+    bool copyBool( bool b ) const { return b; }
+    uint copyUInt( uint i ) const { return i; }
+    qlonglong copyLongLong( qlonglong i ) const { return i; }
+    QStringList copyStringList( const QStringList& l ) const { return l; }
+    QDateTime copyDateTime( const QDateTime& dt ) const { return dt; }
+    QRect copyRect( const QRect& r ) const { return r; }
+    QByteArray copyByteArray( const QByteArray& b ) const { return b; }
+    void storeByteArray( const QByteArray& b ) { byteArray_ = b; }
+    QByteArray storedByteArray() const { return byteArray_; }
+    QList< int > copyIntList( const QList< int >& l ) const { return l; }
+    QVector< short > copyShortVector( const QVector< short >& v ) const { return v; }
+    double sumDoubleVector( const QVector< double >& v ) const {
+        double s = 0;
+        for( int i = 0; i != v.size(); ++i ) s += v[ i ];
+        return s;
+    }
+    QVector< double > copyDoubleVector( const QVector< double >& v ) const { return v; }
+    QVector< float > copyFloatVector( const QVector< float >& v ) const { return v; }
+    int valueOf( QpyTestObject* o ) const { return o ? o->GetValue() : -1; }
+    QpyTestObject* pointerTo( QpyTestObject* o ) const { return o; }
+    int peerValue( QpyTestPeer* p ) const;
+    QpyTestObject* GetLink() const { return link_; }
+    void SetLink( QpyTestObject* l ) { link_ = l; }
+    void destroyObject( QObject* o ) const { delete o; }
+    QpyTestObject* newObject( int value ) const { return new QpyTestObject( value ); }
+    /// Move object to a thread which is never started: queued calls are
+    /// posted and never executed.
+    void moveToIdleThread() {
+        static QThread idle;
+        moveToThread( &idle );
+    }
+    QVariantList copyVariantList( const QVariantList& l ) const { return l; }
+    QVariantMap copyVariantMap( const QVariantMap& m ) const { return m; }
+    QVariantHash copyVariantHash( const QVariantHash& h ) const { return h; }
     void Print() const { std::cout << "Value = " << value_ << std::endl; } 
     void catchSignal( int s ) {
         std::cout << "Caught signal " << s << std::endl;
@@ -48,9 +124,61 @@ public slots:
     void catchAnotherSignal( QString msg ) { 
         std::cout << "Caught another signal " << msg.toStdString() << std::endl;
     }
+    /// Emit reentered( n ) and return @c s after all the connected slots
+    /// have been invoked.
+    QString reenter( const QString& s, int n ) {
+        emit reentered( n );
+        return s;
+    }
+    QString overloaded( int ) const { return "int"; }
+    QString overloaded( double ) const { return "double"; }
+    QString overloaded( const QString& ) const { return "QString"; }
+    QString overloaded( int, int, int k = 0 ) const { return "int, int, int = " + QString::number( k ); }
 signals:
     void aSignal( int );
     void anotherSignal( QString );
+    void reentered( int );
 private:
     int value_;
+    QString text_;
+    double ratio_;
+    QpyTestPoint point_;
+    QSize size_;
+    QByteArray byteArray_;
+    QPointer< QpyTestObject > link_;
+};
+/// References QpyTestObject, which references this type.
+class QpyTestPeer : public QObject {
+    Q_OBJECT
+    Q_PROPERTY( int value READ GetValue )
+public:
+    Q_INVOKABLE QpyTestPeer( int value ) : QObject( 0 ), value_( value ) {}
+public slots:
+    int GetValue() const { return value_; }
+    int valueOf( QpyTestObject* o ) const { return o ? o->GetValue() : -1; }
+private:
+    int value_;
+};
+inline int QpyTestObject::peerValue( QpyTestPeer* p ) const { return p ? p->GetValue() : -1; }
+/// Accepted where pointers to the base type are required.
+class QpyTestDerived : public QpyTestObject {
+    Q_OBJECT
+public:
+    Q_INVOKABLE QpyTestDerived( int value ) : QpyTestObject( value ) {}
+};
+
+/// Type registered by the test driver only when requested from Python;
+/// not declared with Q_DECLARE_METATYPE.
+struct QpyTestLate {
+    int value;
+    QpyTestLate() : value( 0 ) {}
+};
+/// Object with methods referencing a type registered after type creation.
+class QpyLateTestObject : public QObject {
+    Q_OBJECT
+public:
+    Q_INVOKABLE QpyLateTestObject() : QObject( 0 ) {}
+public slots:
+    int lateValue( const QpyTestLate& l ) const { return l.value; }
+    int GetOne() const { return 1; }
 };
@@ -48,4 +48,9 @@ qpy.disconnect(obj, 'aSignal(int)', obj2, 'catchSignal(int)')
 qpy.disconnect(obj.anotherSignal, obj2.catchAnotherSignal)
 
 obj.aSignal(123)
-obj.anotherSignal("123")
\ No newline at end of file
+obj.anotherSignal("123")
+
+try:
+    qpy.connect(obj.aSignal, obj2.catchAnotherSignal)
+except TypeError as e:
+    print(e)
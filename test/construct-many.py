@@ -0,0 +1,50 @@
+# QPy - Copyright (c) 2012,2013 Ugo Varetto
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the author and copyright holder nor the
+#       names of contributors to the project may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import qpy
+import qpy_test
+
+objs = qpy.construct_many(qpy_test.QpyTestObject, [(1,), (2,), (3,)])
+print(qpy.invoke_many(objs, 'GetValue'))
+print(len(qpy.construct_many(qpy_test.QpyTestObject, 4)))
+print(len(qpy.construct_many(qpy_test.QpyTestObject, 2L)))
+try:
+    qpy.construct_many(qpy_test.QpyTestObject, -1)
+except ValueError:
+    print('negative count')
+
+class D(qpy_test.QpyTestObject):
+    def __init__(self, v):
+        qpy_test.QpyTestObject.__init__(self, v * 2)
+
+print([d.GetValue() for d in qpy.construct_many(D, [(1,), (2,)])])
+
+# constructor resolved again when the arguments change
+objs = qpy.construct_many(qpy_test.QpyTestObject, [(1,), tuple(range(11)), (2,)])
+print(qpy.invoke_many(objs, 'GetValue'))
+try:
+    qpy.construct_many(qpy_test.QpyTestObject, [(1,), ('a',)])
+except Exception:
+    print('conversion error')
@@ -0,0 +1,54 @@
+# QPy - Copyright (c) 2012,2013 Ugo Varetto
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the author and copyright holder nor the
+#       names of contributors to the project may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import array
+import qpy
+import qpy_test
+
+objs = [qpy_test.QpyTestObject(i) for i in range(5)]
+
+values = qpy.gather(objs, 'value')
+print(values.typecode)
+print(values.tolist())
+
+qpy.scatter(objs, 'value', array.array('i', [5, 6, 7, 8, 9]))
+print(qpy.gather(objs, 'value').tolist())
+
+qpy.scatter(objs, 'ratio', [0.5, 1.5, 2.5, 3.5, 4.5])
+print(qpy.gather(objs, 'ratio').tolist())
+
+qpy.scatter(objs, 'text', ['a', 'b', 'c', 'd', 'e'])
+print(qpy.gather(objs, 'text'))
+
+try:
+    qpy.scatter(objs, 'value', [1, 2])
+except ValueError:
+    print('wrong number of values')
+
+# property resolved again for each type: read-only in QpyTestPeer
+try:
+    qpy.scatter([objs[0], qpy_test.QpyTestPeer(1)], 'value', array.array('i', [1, 2]))
+except Exception:
+    print('read-only property')
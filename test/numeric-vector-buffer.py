@@ -0,0 +1,50 @@
+# QPy - Copyright (c) 2012,2013 Ugo Varetto
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the author and copyright holder nor the
+#       names of contributors to the project may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+import array
+import qpy_test
+
+obj = qpy_test.QpyTestObject()
+v = obj.copyDoubleVector([1.5, 2.5, 3.5])
+print(type(v).__name__)
+print(len(v))
+print(list(v))
+m = memoryview(v)
+print(m.format)
+print(m.itemsize)
+print(m.readonly)
+print(m.shape)
+print(array.array('d', str(buffer(v))).tolist())
+ai = v.__array_interface__
+print(ai['shape'])
+print(ai['typestr'][1:])
+print(ai['version'])
+# vector data shared with the argument
+print(obj.sumDoubleVector(v))
+print(list(obj.copyDoubleVector(v)))
+f = obj.copyFloatVector(array.array('f', [0.5, 0.25]))
+print(type(f).__name__)
+print(memoryview(f).format)
+print(f.__array_interface__['typestr'][1:])
+print(list(f))
@@ -0,0 +1,66 @@
+# QPy - Copyright (c) 2012,2013 Ugo Varetto
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the author and copyright holder nor the
+#       names of contributors to the project may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import UserDict
+import qpy
+import qpy_test
+
+obj = qpy_test.QpyTestObject(3)
+obj.text = 'a string'
+obj.ratio = 0.5
+
+props = qpy.get_properties(obj, ['value', 'text', 'ratio'])
+print(sorted(props.items()))
+
+qpy.set_properties(obj, {'value': 4, 'text': 'another string'})
+print(obj.value)
+print(obj.text)
+
+# any mapping is accepted
+qpy.set_properties(obj, UserDict.UserDict({'value': 6}))
+print(obj.value)
+
+# properties are written only if all the names and values are valid
+try:
+    qpy.set_properties(obj, {'value': 7, 'notAProperty': 1})
+except AttributeError:
+    print('no property')
+try:
+    qpy.set_properties(obj, {'value': 7, 'ratio': 'not a number'})
+except Exception:
+    print('conversion failed')
+print(obj.value)
+
+ps = qpy.property_set(qpy_test.QpyTestObject, ('ratio', 'value'))
+qpy.set_properties(obj, ps, (1.5, 5))
+print(sorted(qpy.get_properties(obj, ps).items()))
+
+try:
+    qpy.get_properties(obj, ['notAProperty'])
+except AttributeError:
+    print('no property')
+
+print(obj.object is obj)
+print(qpy.get_properties(obj, ['object'])['object'] is obj)
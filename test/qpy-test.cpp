@@ -30,6 +30,64 @@
 static PyMethodDef empty_module_methods[] = {
     {NULL}  /* Sentinel */
 };
+/// QpyTestPoint <--> Python (x, y) tuple
+struct PointConverter {
+    PyObject* ToPy( const QpyTestPoint& p ) const {
+        return Py_BuildValue( "(dd)", p.x, p.y );
+    }
+    bool FromPy( PyObject* obj, QpyTestPoint& p ) const {
+        if( !PyTuple_Check( obj ) ) {
+            PyErr_SetString( PyExc_TypeError, "Tuple required" );
+            return false;
+        }
+        return PyArg_ParseTuple( obj, "dd", &p.x, &p.y ) != 0;
+    }
+    int Check( PyObject* obj ) const { return PyTuple_Check( obj ) ? 2 : 0; }
+};
+/// QpyTestLate <--> Python int
+struct LateConverter {
+    PyObject* ToPy( const QpyTestLate& l ) const { return PyInt_FromLong( l.value ); }
+    bool FromPy( PyObject* obj, QpyTestLate& l ) const {
+        if( !PyInt_Check( obj ) ) {
+            PyErr_SetString( PyExc_TypeError, "Int required" );
+            return false;
+        }
+        l.value = int( PyInt_AS_LONG( obj ) );
+        return true;
+    }
+    int Check( PyObject* obj ) const { return PyInt_Check( obj ) ? 2 : 0; }
+};
+/// Context used by the qpy_driver module functions
+static qpy::PyContext* context = 0;
+static PyObject* RegisterLateTypes( PyObject*, PyObject* ) {
+    context->RegisterConverter< QpyTestLate, LateConverter >( "QpyTestLate" );
+    Py_RETURN_NONE;
+}
+static PyObject* ClearFreeList( PyObject*, PyObject* ) {
+    return PyInt_FromLong( qpy::PyContext::ClearFreeList() );
+}
+static PyObject* SetStringCacheSize( PyObject*, PyObject* args ) {
+    int entries = 0;
+    if( !PyArg_ParseTuple( args, "i", &entries ) ) return 0;
+    qpy::PyContext::SetStringCacheSize( entries );
+    Py_RETURN_NONE;
+}
+/// Functions giving scripts access to the context of the test driver
+static PyMethodDef driver_module_methods[] = {
+    { "register_late_types", RegisterLateTypes, METH_NOARGS,
+      "Register converters of QpyTestLate" },
+    { "clear_free_list", ClearFreeList, METH_NOARGS,
+      "Release unused wrappers; returns number of released wrappers" },
+    { "set_string_cache_size", SetStringCacheSize, METH_VARARGS,
+      "Set number of entries of the string cache" },
+    {NULL}  /* Sentinel */
+};
+/// Return lazy views from QVariant container copy methods
+struct ViewNameMapper : qpy::DefaultMemberNameMapper {
+    bool returnView( const QString& sig ) const {
+        return sig.startsWith( "copyVariant" );
+    }
+};
 int main( int argc, char** argv ) {
     if( argc != 2 ) {
         std::cout << "Usage: " << argv[ 0 ] 
@@ -38,6 +96,7 @@ int main( int argc, char** argv ) {
     }
     Py_Initialize();
     qpy::PyContext py;
+    context = &py;
     PyObject* qpyModule = Py_InitModule3( "qpy", py.ModuleFunctions(),
                             "QPy module - where qpy functions reside" );
     py.AddGlobals( qpyModule );
@@ -48,13 +107,42 @@ int main( int argc, char** argv ) {
     PyObject* mainModule = PyImport_AddModule( "__main__" );
     PyModule_AddObject( mainModule, "qpy", qpyModule ); 
     PyModule_AddObject( mainModule, "qpy_test", userModule ); 
+    py.RegisterConverter< QpyTestPoint, PointConverter >();
     py.Add< QpyTestObject >( userModule );
+    // types referenced by the methods of QpyTestObject
+    py.Add< QpyTestPeer >( userModule );
+    py.Add< QpyTestDerived >( userModule );
+    // same type, members added on first access
+    PyObject* lazyModule = Py_InitModule3( "qpy_lazy", py.ModuleFunctions(),
+                            "User module - lazily created types" );
+    Py_INCREF( lazyModule );
+    PyModule_AddObject( mainModule, "qpy_lazy", lazyModule ); 
+    py.SetLazyTypes( true );
+    py.Add< QpyTestObject >( lazyModule );
+    // methods referencing types registered after type creation
+    py.Add< QpyLateTestObject >( lazyModule );
+    py.SetLazyTypes( false );
+    // same type, QVariant containers returned as lazy views
+    PyObject* viewModule = Py_InitModule3( "qpy_view", py.ModuleFunctions(),
+                            "User module - lazy views of returned containers" );
+    Py_INCREF( viewModule );
+    PyModule_AddObject( mainModule, "qpy_view", viewModule ); 
+    py.Add< QpyTestObject >( viewModule, true, QSet< QString >(), ViewNameMapper() );
+    PyObject* driverModule = Py_InitModule3( "qpy_driver", driver_module_methods,
+                            "Test driver module - access to the context" );
+    Py_INCREF( driverModule );
+    PyModule_AddObject( mainModule, "qpy_driver", driverModule ); 
 
     QpyTestObject* to = new QpyTestObject( 71 );
     py.AddObject( to, mainModule, userModule, "myqobj" );
 
     PyRun_SimpleFile( fopen( argv[ 1 ], "r" ), argv[ 1 ] );
-    Py_Finalize();
+    // wrapped objects must be deleted while the interpreter is alive
     delete to;
+    // context destroyed after the interpreter: release wrappers and cached
+    // strings now
+    qpy::PyContext::ClearFreeList();
+    qpy::PyContext::SetStringCacheSize( 0 );
+    Py_Finalize();
     return 0;
 }
@@ -37,6 +37,7 @@ to.SetDefaultValue()
 to.Print()
 
 to2 = to.Self()
+print(to2 is to)
 to2.Print()
 to2.SetValue(5)
 to2.Print()
@@ -53,6 +54,8 @@ print("PROPERTY: {0}".format(to2.value))
 myqobj.Print()
 
 print(qpy.is_qobject(myqobj))
+print(qpy.is_qobject(1))
+print(isinstance(myqobj, qpy.QObject))
 
 print(qpy.is_foreign_owned(myqobj))
 
@@ -0,0 +1,56 @@
+# QPy - Copyright (c) 2012,2013 Ugo Varetto
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the author and copyright holder nor the
+#       names of contributors to the project may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+import qpy_test
+
+obj = qpy_test.QpyTestObject(3)
+other = qpy_test.QpyTestObject(5)
+print(obj.valueOf(other))
+print(obj.valueOf(None))
+print(obj.pointerTo(other) is other)
+print(type(obj.pointerTo(other)).__name__)
+print(obj.pointerTo(None))
+try:
+    obj.valueOf(1)
+except TypeError as e:
+    print(e)
+# QpyTestPeer added after QpyTestObject
+peer = qpy_test.QpyTestPeer(7)
+print(obj.peerValue(peer))
+print(peer.valueOf(obj))
+try:
+    obj.valueOf(peer)
+except TypeError as e:
+    print(e)
+try:
+    obj.peerValue(other)
+except TypeError as e:
+    print(e)
+derived = qpy_test.QpyTestDerived(9)
+print(obj.valueOf(derived))
+print(type(obj.pointerTo(derived)).__name__)
+obj.link = derived
+print(obj.link is derived)
+obj.link = None
+print(obj.link)
@@ -0,0 +1,53 @@
+# QPy - Copyright (c) 2012,2013 Ugo Varetto
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the author and copyright holder nor the
+#       names of contributors to the project may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+import qpy_test
+
+obj = qpy_test.QpyTestObject()
+print(obj.copyVariantList([1, 2.5, 'a', None, True, (1, [2]), {'k': 3}]))
+m = obj.copyVariantMap({'a': 1, 'b': [1, 2], 'c': {'d': 'e'}})
+print(sorted(m.items()))
+print(obj.copyVariantHash({'x': (1, 2)}))
+# nesting depth is not limited by the C stack
+deep = []
+l = deep
+for i in range(5000):
+    l.append([])
+    l = l[0]
+l = obj.copyVariantList(deep)
+depth = 0
+while l:
+    l = l[0]
+    depth += 1
+print(depth)
+cyclic = [1]
+cyclic.append(cyclic)
+try:
+    obj.copyVariantList(cyclic)
+except ValueError as e:
+    print(e)
+try:
+    obj.copyVariantMap({1: 2})
+except TypeError as e:
+    print(e)
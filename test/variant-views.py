@@ -0,0 +1,60 @@
+# QPy - Copyright (c) 2012,2013 Ugo Varetto
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the author and copyright holder nor the
+#       names of contributors to the project may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL UGO VARETTO BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+import qpy_view
+
+obj = qpy_view.QpyTestObject()
+l = obj.copyVariantList([1, 'a', [2, 3], {'k': 4}])
+print(type(l).__name__)
+print(len(l))
+print(l[0])
+print(l[-3])
+print(list(l[2]))
+print(l[3]['k'])
+print('a' in l)
+print(5 in l)
+print([2, 3] in l)
+print({'k': 4} in l)
+print([x for x in l][:2])
+try:
+    l[4]
+except IndexError as e:
+    print(e)
+m = obj.copyVariantMap({'a': 1, 'b': [1, 2]})
+print(type(m).__name__)
+print(len(m))
+print(m['a'])
+print(list(m['b']))
+print('b' in m)
+print('c' in m)
+print(1 in m)
+print(sorted(m))
+print(sorted(m.keys()))
+print(m.get('c', 3))
+try:
+    m['c']
+except KeyError as e:
+    print(repr(e))
+h = obj.copyVariantHash({'x': 1})
+print(dict(h))